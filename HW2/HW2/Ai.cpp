@@ -0,0 +1,130 @@
+#include "Ai.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AI_USE_SSE2 1
+#endif
+
+// tumbleweed x where it touches the right cowboy; the collision box of a
+// cowboy sits at twice its position in tumbleweed units and is 1 wide each way
+const float AI_INTERCEPT_X = COWBOY_OFFSET * 2.0f - cowboy_scale.x - tumbleweed_scale.x / 2.0f;
+// don't chase the target closer than this, the cowboy can't stop anyway
+const float AI_DEAD_ZONE = 0.2f;
+// slower sideways than this and the tumbleweed is treated as moving away; the
+// slope to the cowboy's side stays small enough for the fold below to be exact
+const float AI_MIN_APPROACH_SPEED = 1e-3f;
+const float AI_FOLD_PERIOD = 4.0f * TUMBLEWEED_WALL;
+const float AI_INVERSE_FOLD_PERIOD = 1.0f / AI_FOLD_PERIOD;
+// floats this large are already whole numbers
+const float AI_FLOAT_INTEGRAL = 8388608.0f;
+
+// The wall bounces turn y into a triangle wave between -TUMBLEWEED_WALL and
+// TUMBLEWEED_WALL. Unfold the path, then fold the result back into the walls.
+// ai_choose_inputs() does the same operations in the same order four lanes at
+// a time, so the two give identical inputs; keep them in step.
+static float ai_target_y(float x, float y, float movement_x, float movement_y, float side)
+{
+    // moving away: wait in the middle
+    if (movement_x * side <= AI_MIN_APPROACH_SPEED) return 0.0f;
+
+    float unfolded_y = y + movement_y / movement_x * (AI_INTERCEPT_X * side - x);
+
+    float phase = unfolded_y + TUMBLEWEED_WALL;
+    phase = phase - AI_FOLD_PERIOD * std::floor(phase * AI_INVERSE_FOLD_PERIOD);
+    float target = phase <= 2.0f * TUMBLEWEED_WALL ? phase - TUMBLEWEED_WALL : 3.0f * TUMBLEWEED_WALL - phase;
+
+    // the cowboys can't leave the screen; compared the way _mm_min_ps and
+    // _mm_max_ps do, so a NaN comes through both paths alike
+    target = WALL_BORDER < target ? WALL_BORDER : target;
+    return -WALL_BORDER > target ? -WALL_BORDER : target;
+}
+
+static uint8_t ai_input_towards(float target_y, float cowboy_y, int player)
+{
+    uint8_t up = player == 0 ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+    uint8_t down = player == 0 ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+
+    if (target_y > cowboy_y + AI_DEAD_ZONE) return up;
+    if (target_y < cowboy_y - AI_DEAD_ZONE) return down;
+    return 0;
+}
+
+uint8_t ai_choose_input(const GameState& state, int player)
+{
+    float side = player == 0 ? -1.0f : 1.0f;
+    float cowboy_y = player == 0 ? state.left_cowboy_position.y : state.right_cowboy_position.y;
+
+    float target_y = ai_target_y(state.tumbleweed_position.x, state.tumbleweed_position.y,
+        state.tumbleweed_movement.x, state.tumbleweed_movement.y, side);
+    return ai_input_towards(target_y, cowboy_y, player);
+}
+
+void ai_choose_inputs(const AiBatch& batch, int player)
+{
+    float side = player == 0 ? -1.0f : 1.0f;
+    size_t i = 0;
+
+#ifdef AI_USE_SSE2
+    const __m128 side4 = _mm_set1_ps(side);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 min_approach_speed = _mm_set1_ps(AI_MIN_APPROACH_SPEED);
+    const __m128 intercept_x = _mm_set1_ps(AI_INTERCEPT_X * side);
+    const __m128 wall = _mm_set1_ps(TUMBLEWEED_WALL);
+    const __m128 period = _mm_set1_ps(AI_FOLD_PERIOD);
+    const __m128 inverse_period = _mm_set1_ps(AI_INVERSE_FOLD_PERIOD);
+    const __m128 integral = _mm_set1_ps(AI_FLOAT_INTEGRAL);
+    const __m128 sign_bit = _mm_set1_ps(-0.0f);
+    const __m128 half_period = _mm_set1_ps(2.0f * TUMBLEWEED_WALL);
+    const __m128 three_walls = _mm_set1_ps(3.0f * TUMBLEWEED_WALL);
+    const __m128 border = _mm_set1_ps(WALL_BORDER);
+    const __m128 dead_zone = _mm_set1_ps(AI_DEAD_ZONE);
+    const int up = player == 0 ? INPUT_LEFT_UP : INPUT_RIGHT_UP;
+    const int down = player == 0 ? INPUT_LEFT_DOWN : INPUT_RIGHT_DOWN;
+
+    for (; i + 4 <= batch.count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(batch.tumbleweed_x + i);
+        __m128 y = _mm_loadu_ps(batch.tumbleweed_y + i);
+        __m128 movement_x = _mm_loadu_ps(batch.tumbleweed_movement_x + i);
+        __m128 movement_y = _mm_loadu_ps(batch.tumbleweed_movement_y + i);
+        __m128 cowboy_y = _mm_loadu_ps(batch.cowboy_y + i);
+
+        __m128 approaching = _mm_cmpgt_ps(_mm_mul_ps(movement_x, side4), min_approach_speed);
+        // keep the division finite for lanes that are moving away, they're masked out below
+        __m128 safe_movement_x = _mm_or_ps(_mm_and_ps(approaching, movement_x), _mm_andnot_ps(approaching, one));
+        __m128 unfolded_y = _mm_add_ps(y, _mm_mul_ps(_mm_div_ps(movement_y, safe_movement_x), _mm_sub_ps(intercept_x, x)));
+
+        // phase - period * floor(phase * inverse_period), floor from truncation;
+        // quotients too big for an int are whole already and kept as they are
+        __m128 phase = _mm_add_ps(unfolded_y, wall);
+        __m128 quotient = _mm_mul_ps(phase, inverse_period);
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(quotient));
+        __m128 floored = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, quotient), one));
+        __m128 fits_int = _mm_cmplt_ps(_mm_andnot_ps(sign_bit, quotient), integral);
+        floored = _mm_or_ps(_mm_and_ps(fits_int, floored), _mm_andnot_ps(fits_int, quotient));
+        phase = _mm_sub_ps(phase, _mm_mul_ps(period, floored));
+
+        __m128 rising = _mm_cmple_ps(phase, half_period);
+        __m128 target = _mm_or_ps(_mm_and_ps(rising, _mm_sub_ps(phase, wall)),
+            _mm_andnot_ps(rising, _mm_sub_ps(three_walls, phase)));
+        target = _mm_max_ps(_mm_sub_ps(zero, border), _mm_min_ps(border, target));
+        target = _mm_and_ps(approaching, target);
+
+        int press_up = _mm_movemask_ps(_mm_cmpgt_ps(target, _mm_add_ps(cowboy_y, dead_zone)));
+        int press_down = _mm_movemask_ps(_mm_cmplt_ps(target, _mm_sub_ps(cowboy_y, dead_zone)));
+        for (int lane = 0; lane < 4; lane++)
+        {
+            batch.inputs[i + lane] = (uint8_t)(((press_up >> lane) & 1) * up | ((press_down >> lane) & 1) * down);
+        }
+    }
+#endif
+
+    for (; i < batch.count; i++)
+    {
+        float target_y = ai_target_y(batch.tumbleweed_x[i], batch.tumbleweed_y[i],
+            batch.tumbleweed_movement_x[i], batch.tumbleweed_movement_y[i], side);
+        batch.inputs[i] = ai_input_towards(target_y, batch.cowboy_y[i], player);
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Simulation.h"
+
+// Computer player for either cowboy. It predicts where the tumbleweed will
+// cross the cowboy's side, folding the wall bounces in closed form, and
+// presses up or down to get there.
+
+// input bits for player 0 (left) or 1 (right)
+uint8_t ai_choose_input(const GameState& state, int player);
+
+// Many matches' worth of AI players at once, one array per field so the
+// evaluation runs four paddles per SSE2 instruction.
+struct AiBatch
+{
+    const float* tumbleweed_x;
+    const float* tumbleweed_y;
+    const float* tumbleweed_movement_x;
+    const float* tumbleweed_movement_y;
+    const float* cowboy_y;
+    uint8_t* inputs; // written, masked to the player's bits
+    size_t count;
+};
+
+void ai_choose_inputs(const AiBatch& batch, int player);
@@ -0,0 +1,33 @@
+#include "Culling.h"
+#include "glm/glm.hpp"
+#include <cfloat>
+
+bool sprite_is_visible(const glm::mat4& model_matrix, const glm::mat4& view_projection_matrix)
+{
+    glm::mat4 clip_matrix = view_projection_matrix * model_matrix;
+
+    // the quad's x and y edges in clip space; parallel or zero edges mean no area
+    glm::vec2 edge_x = glm::vec2(clip_matrix[0]);
+    glm::vec2 edge_y = glm::vec2(clip_matrix[1]);
+    if (edge_x.x * edge_y.y - edge_x.y * edge_y.x == 0.0f) return false;
+
+    const glm::vec2 corners[4] = {
+        glm::vec2(-0.5f, -0.5f), glm::vec2(0.5f, -0.5f),
+        glm::vec2(0.5f, 0.5f), glm::vec2(-0.5f, 0.5f)
+    };
+
+    glm::vec2 bounds_min = glm::vec2(FLT_MAX);
+    glm::vec2 bounds_max = glm::vec2(-FLT_MAX);
+    for (const glm::vec2& corner : corners)
+    {
+        glm::vec4 clip = clip_matrix * glm::vec4(corner, 0.0f, 1.0f);
+        if (clip.w <= 0.0f) return true; // behind a perspective camera, leave it to the GPU
+
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        bounds_min = glm::min(bounds_min, ndc);
+        bounds_max = glm::max(bounds_max, ndc);
+    }
+
+    return bounds_max.x >= -1.0f && bounds_min.x <= 1.0f &&
+        bounds_max.y >= -1.0f && bounds_min.y <= 1.0f;
+}
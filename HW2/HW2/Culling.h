@@ -0,0 +1,14 @@
+#pragma once
+
+#include "glm/mat4x4.hpp"
+
+// Sprites are unit quads centred on their model matrix's origin. A sprite is
+// culled when its quad has no area (a zero scale) or its bounds fall entirely
+// outside the view volume's x/y rectangle.
+bool sprite_is_visible(const glm::mat4& model_matrix, const glm::mat4& view_projection_matrix);
+
+struct CullStats
+{
+    int drawn = 0;
+    int culled = 0;
+};
@@ -0,0 +1,319 @@
+#define GL_SILENCE_DEPRECATION
+
+#include "FrameCapture.h"
+#include "Headless.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+const GLuint64 FRAME_CAPTURE_WAIT_NS = 1000000;
+// widest zero padding an image pattern may ask for, an int needs at most 11 characters
+const int IMAGE_INDEX_MAX_WIDTH = 15;
+
+bool FrameCapture::start(const char* path, int width, int height, int frames_per_second, bool wait_for_writer)
+{
+    m_path = path;
+    m_width = width;
+    m_height = height;
+    m_frame_size = (size_t)width * height * 4;
+    m_wait_for_writer = wait_for_writer;
+
+    size_t length = m_path.size();
+    if (length >= 4 && m_path.compare(length - 4, 4, ".y4m") == 0)
+    {
+        m_video = fopen(path, "wb");
+        if (m_video == NULL) return false;
+        // full range BT.601 with centred chroma, what C420jpeg means to players
+        fprintf(m_video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, frames_per_second);
+    }
+    else if (!parse_image_pattern(path))
+    {
+        printf("%s: image patterns need one %%d for the frame number, at most %d wide, e.g. frames/%%05d.ppm\n",
+            path, IMAGE_INDEX_MAX_WIDTH);
+        return false;
+    }
+
+    // without fences there's no telling when a buffer is ready, so frames
+    // are read straight into client memory and the read waits for the GPU
+    m_use_fences = gl_version() >= 32 || gl_extension_supported("GL_ARB_sync");
+    if (m_use_fences)
+    {
+        for (ReadbackBuffer& buffer : m_buffers)
+        {
+            glGenBuffers(1, &buffer.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)m_frame_size, NULL, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    else
+    {
+        printf("Fence sync not supported, capturing frames without pixel buffers\n");
+    }
+
+    m_next_buffer = 0;
+    m_frames_written = m_frames_dropped = m_write_errors = 0;
+    m_running = true;
+    m_thread = std::thread(&FrameCapture::run, this);
+    return true;
+}
+
+// splits e.g. "frames/%05d.ppm" around its one %d, never used as a format string;
+// %% is a literal percent sign
+bool FrameCapture::parse_image_pattern(const char* pattern)
+{
+    m_image_prefix.clear();
+    m_image_suffix.clear();
+    m_image_index_width = 0;
+
+    bool has_index = false;
+    for (const char* c = pattern; *c != '\0'; c++)
+    {
+        std::string& text = has_index ? m_image_suffix : m_image_prefix;
+        if (*c != '%')
+        {
+            text += *c;
+            continue;
+        }
+        if (c[1] == '%')
+        {
+            text += '%';
+            c++;
+            continue;
+        }
+
+        // % then an optional zero padded width, then d
+        const char* conversion = c + 1;
+        if (*conversion == '0') conversion++;
+        int width = 0;
+        while (*conversion >= '0' && *conversion <= '9' && width < 100) width = width * 10 + (*conversion++ - '0');
+        if (*conversion != 'd' || has_index || width > IMAGE_INDEX_MAX_WIDTH) return false;
+
+        has_index = true;
+        m_image_index_width = width;
+        c = conversion;
+    }
+    return has_index;
+}
+
+void FrameCapture::stop()
+{
+    if (!m_running) return;
+
+    // oldest first, so the frames stay in order
+    for (int i = 0; i < FRAME_CAPTURE_BUFFERS; i++)
+    {
+        ReadbackBuffer& buffer = m_buffers[(m_next_buffer + i) % FRAME_CAPTURE_BUFFERS];
+        if (buffer.fence != NULL) collect(buffer);
+    }
+
+    // the worker writes everything queued before it returns
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+
+    for (ReadbackBuffer& buffer : m_buffers)
+    {
+        if (buffer.buffer != 0) glDeleteBuffers(1, &buffer.buffer);
+        buffer = ReadbackBuffer();
+    }
+    m_free_frames.clear();
+
+    if (m_video != NULL && fclose(m_video) != 0) m_write_errors++;
+    m_video = NULL;
+
+    printf("Captured %d frames to %s", m_frames_written, m_path.c_str());
+    if (m_frames_dropped > 0) printf(", dropped %d the writer couldn't keep up with", m_frames_dropped);
+    if (m_write_errors > 0) printf(", %d FAILED to write", m_write_errors);
+    printf("\n");
+}
+
+void FrameCapture::capture()
+{
+    PROFILE_ZONE("capture_frame");
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    if (!m_use_fences)
+    {
+        std::vector<uint8_t> frame;
+        if (!take_free_frame(frame)) return;
+        glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, frame.data());
+        queue_frame(frame);
+        return;
+    }
+
+    // the buffer about to be reused was read FRAME_CAPTURE_BUFFERS frames
+    // ago, so its pixels are almost always there already
+    ReadbackBuffer& buffer = m_buffers[m_next_buffer];
+    if (buffer.fence != NULL) collect(buffer);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.buffer);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_next_buffer = (m_next_buffer + 1) % FRAME_CAPTURE_BUFFERS;
+}
+
+// copies a finished readback out of its buffer and queues it for the writer
+void FrameCapture::collect(ReadbackBuffer& buffer)
+{
+    while (glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FRAME_CAPTURE_WAIT_NS) == GL_TIMEOUT_EXPIRED) {}
+    glDeleteSync(buffer.fence);
+    buffer.fence = NULL;
+
+    std::vector<uint8_t> frame;
+    if (!take_free_frame(frame)) return;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.buffer);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)m_frame_size, GL_MAP_READ_BIT);
+    if (mapped != NULL)
+    {
+        memcpy(frame.data(), mapped, m_frame_size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (mapped != NULL) queue_frame(frame);
+}
+
+// false if the writer is too far behind and this frame should be dropped
+bool FrameCapture::take_free_frame(std::vector<uint8_t>& frame)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_wait_for_writer)
+        {
+            PROFILE_ZONE("wait_for_writer");
+            m_written_condition.wait(lock, [this] { return m_frames.size() < FRAME_CAPTURE_QUEUE_LIMIT; });
+        }
+        else if (m_frames.size() >= FRAME_CAPTURE_QUEUE_LIMIT)
+        {
+            m_frames_dropped++;
+            return false;
+        }
+        if (!m_free_frames.empty())
+        {
+            frame.swap(m_free_frames.back());
+            m_free_frames.pop_back();
+        }
+    }
+    frame.resize(m_frame_size);
+    return true;
+}
+
+void FrameCapture::queue_frame(std::vector<uint8_t>& frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frames.push_back(std::move(frame));
+    }
+    m_condition.notify_one();
+}
+
+void FrameCapture::run()
+{
+    profiler_set_thread_name("frame_capture");
+
+    std::vector<uint8_t> scratch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return !m_running || !m_frames.empty(); });
+        if (m_frames.empty()) return;
+
+        std::vector<uint8_t> frame = std::move(m_frames.front());
+        m_frames.pop_front();
+        int index = m_frames_written + m_write_errors;
+        lock.unlock();
+        m_written_condition.notify_one();
+
+        write_frame(frame, index, scratch);
+
+        lock.lock();
+        m_free_frames.push_back(std::move(frame));
+    }
+}
+
+static inline uint8_t clamp_to_byte(int value)
+{
+    return (uint8_t)std::min(std::max(value, 0), 255);
+}
+
+// runs on the worker; frames are bottom row first and come out top row first
+void FrameCapture::write_frame(const std::vector<uint8_t>& rgba, int index, std::vector<uint8_t>& scratch)
+{
+    PROFILE_ZONE("write_frame");
+    bool written;
+
+    if (m_video != NULL)
+    {
+        // I420: a full size Y plane, then U and V at half size each way
+        int chroma_width = (m_width + 1) / 2,
+            chroma_height = (m_height + 1) / 2;
+        size_t luma_size = (size_t)m_width * m_height,
+            chroma_size = (size_t)chroma_width * chroma_height;
+        scratch.resize(luma_size + chroma_size * 2);
+        uint8_t* luma = scratch.data();
+        uint8_t* u = luma + luma_size;
+        uint8_t* v = u + chroma_size;
+
+        for (int y = 0; y < m_height; y++)
+        {
+            const uint8_t* row = &rgba[(size_t)(m_height - 1 - y) * m_width * 4];
+            uint8_t* out = luma + (size_t)y * m_width;
+            for (int x = 0; x < m_width; x++)
+            {
+                out[x] = (uint8_t)((77 * row[x * 4] + 150 * row[x * 4 + 1] + 29 * row[x * 4 + 2] + 128) >> 8);
+            }
+        }
+
+        // chroma from the average of each 2x2 block, odd edges repeat their last pixel
+        for (int y = 0; y < chroma_height; y++)
+        {
+            int y0 = std::min(y * 2, m_height - 1), y1 = std::min(y * 2 + 1, m_height - 1);
+            const uint8_t* row0 = &rgba[(size_t)(m_height - 1 - y0) * m_width * 4];
+            const uint8_t* row1 = &rgba[(size_t)(m_height - 1 - y1) * m_width * 4];
+            for (int x = 0; x < chroma_width; x++)
+            {
+                int x0 = std::min(x * 2, m_width - 1) * 4, x1 = std::min(x * 2 + 1, m_width - 1) * 4;
+                int r = row0[x0] + row0[x1] + row1[x0] + row1[x1],
+                    g = row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1],
+                    b = row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2];
+                // the sums are 4x the average, so shift by 10 rather than 8; the
+                // 128 offset goes in first so nothing negative is shifted
+                u[(size_t)y * chroma_width + x] = clamp_to_byte((-43 * r - 85 * g + 128 * b + (128 << 10) + 512) >> 10);
+                v[(size_t)y * chroma_width + x] = clamp_to_byte((128 * r - 107 * g - 21 * b + (128 << 10) + 512) >> 10);
+            }
+        }
+
+        written = fputs("FRAME\n", m_video) >= 0 && fwrite(scratch.data(), 1, scratch.size(), m_video) == scratch.size();
+    }
+    else
+    {
+        scratch.resize((size_t)m_width * m_height * 3);
+        for (int y = 0; y < m_height; y++)
+        {
+            const uint8_t* row = &rgba[(size_t)(m_height - 1 - y) * m_width * 4];
+            uint8_t* out = &scratch[(size_t)y * m_width * 3];
+            for (int x = 0; x < m_width; x++)
+            {
+                out[x * 3] = row[x * 4];
+                out[x * 3 + 1] = row[x * 4 + 1];
+                out[x * 3 + 2] = row[x * 4 + 2];
+            }
+        }
+
+        char number[IMAGE_INDEX_MAX_WIDTH + 1];
+        snprintf(number, sizeof(number), "%0*d", m_image_index_width, index);
+        std::string filepath = m_image_prefix + number + m_image_suffix;
+        written = write_ppm(filepath.c_str(), m_width, m_height, scratch);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (written) m_frames_written++;
+    else m_write_errors++;
+}
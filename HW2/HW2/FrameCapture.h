@@ -0,0 +1,84 @@
+#pragma once
+
+#include "GlUtil.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// readbacks in flight, each frame's pixels are collected this many frames after it's drawn
+const int FRAME_CAPTURE_BUFFERS = 3;
+// frames waiting on the writer before new ones are dropped, or wait for it,
+// so a slow disk never costs more memory than this
+const size_t FRAME_CAPTURE_QUEUE_LIMIT = 30;
+
+// Records every drawn frame without stalling the thread that draws. capture()
+// asks for the framebuffer to be copied into a pixel buffer object, which the
+// GPU does in the background; a fence says when it's done, and the pixels are
+// collected the next time that buffer comes round the ring and handed to a
+// worker thread that converts and writes them. A path ending in .y4m gets one
+// raw YUV 4:2:0 video, anything else is a pattern for numbered PPM images
+// holding one %d, optionally zero padded, e.g. frames/%05d.ppm. Everything but the writing runs on the thread
+// with the GL context, which may change between calls but not during one.
+class FrameCapture
+{
+private:
+    struct ReadbackBuffer
+    {
+        GLuint buffer = 0;
+        GLsync fence = NULL; // NULL when free
+    };
+
+    std::string m_path;
+    // image file names are prefix, index padded to index_width, suffix
+    std::string m_image_prefix,
+        m_image_suffix;
+    int m_image_index_width = 0;
+    FILE* m_video = NULL; // NULL when writing images
+    int m_width = 0,
+        m_height = 0;
+    size_t m_frame_size = 0;
+    bool m_wait_for_writer = false;
+
+    bool m_use_fences = false;
+    ReadbackBuffer m_buffers[FRAME_CAPTURE_BUFFERS];
+    int m_next_buffer = 0;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition,
+        m_written_condition;
+    bool m_running = false;
+    std::deque<std::vector<uint8_t>> m_frames, // RGBA, bottom row first as GL reads them
+        m_free_frames;
+    int m_frames_written = 0,
+        m_frames_dropped = 0,
+        m_write_errors = 0;
+
+    bool parse_image_pattern(const char* pattern);
+    void run();
+    void collect(ReadbackBuffer& buffer);
+    bool take_free_frame(std::vector<uint8_t>& frame);
+    void queue_frame(std::vector<uint8_t>& frame);
+    void write_frame(const std::vector<uint8_t>& rgba, int index, std::vector<uint8_t>& scratch);
+
+public:
+    // Needs a current GL context, returns false if the output can't be opened
+    // or an image pattern doesn't hold exactly one %d padded to at most 15 digits.
+    // When the writer falls behind, frames are dropped so the game keeps its
+    // frame rate, or with wait_for_writer capture() blocks until there's room,
+    // for offscreen runs where every frame matters more than the time taken.
+    bool start(const char* path, int width, int height, int frames_per_second, bool wait_for_writer = false);
+    // collects the frames still in flight, waits for them to be written and
+    // frees the buffers, needs the GL context
+    void stop();
+
+    // call after drawing and before the swap, reads the bound framebuffer
+    void capture();
+
+    bool is_running() const { return m_running; }
+};
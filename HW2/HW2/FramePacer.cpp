@@ -0,0 +1,129 @@
+#include "FramePacer.h"
+#include "Profiler.h"
+#include <SDL.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+const uint64_t PACER_SPIN_NS = 2000000;
+
+bool FramePacer::parse(const char* description)
+{
+    if (strcmp(description, "vsync") == 0) m_mode = PACING_VSYNC;
+    else if (strcmp(description, "vsync-locked") == 0) m_mode = PACING_VSYNC_LOCKED;
+    else if (strcmp(description, "adaptive") == 0) m_mode = PACING_ADAPTIVE_VSYNC;
+    else if (strcmp(description, "uncapped") == 0) m_mode = PACING_UNCAPPED;
+    else if (strncmp(description, "capped:", 7) == 0)
+    {
+        double fps = atof(description + 7);
+        if (fps <= 0.0) return false;
+
+        m_mode = PACING_CAPPED;
+        m_frame_ns = (uint64_t)(1000000000.0 / fps);
+    }
+    else return false;
+
+    return true;
+}
+
+void FramePacer::apply_swap_interval() const
+{
+    switch (m_mode)
+    {
+        case PACING_VSYNC:
+        case PACING_VSYNC_LOCKED:
+            SDL_GL_SetSwapInterval(1);
+            break;
+        case PACING_ADAPTIVE_VSYNC:
+            if (SDL_GL_SetSwapInterval(-1) != 0)
+            {
+                printf("Adaptive vsync not supported, using vsync\n");
+                SDL_GL_SetSwapInterval(1);
+            }
+            break;
+        case PACING_CAPPED:
+        case PACING_UNCAPPED:
+            SDL_GL_SetSwapInterval(0);
+            break;
+    }
+}
+
+void FramePacer::wait_for_next_frame()
+{
+    if (m_mode != PACING_CAPPED) return;
+
+    PROFILE_ZONE("frame_pacing");
+
+    uint64_t now = profiler_now_ns();
+    if (m_next_frame_ns == 0 || now > m_next_frame_ns + m_frame_ns)
+    {
+        // first frame, or too far behind to catch up: start the schedule from now
+        m_next_frame_ns = now + m_frame_ns;
+        return;
+    }
+
+    while (m_next_frame_ns > now + PACER_SPIN_NS)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(m_next_frame_ns - now - PACER_SPIN_NS));
+        now = profiler_now_ns();
+    }
+    while (profiler_now_ns() < m_next_frame_ns) std::this_thread::yield();
+
+    m_next_frame_ns += m_frame_ns;
+}
+
+void LatencyHistogram::record(uint64_t latency_ns)
+{
+    uint64_t bucket = latency_ns / LATENCY_BUCKET_NS;
+    if (bucket >= (uint64_t)LATENCY_BUCKET_COUNT) bucket = LATENCY_BUCKET_COUNT - 1;
+
+    m_buckets[bucket]++;
+    m_count++;
+    m_total_ns += latency_ns;
+    if (latency_ns > m_max_ns) m_max_ns = latency_ns;
+}
+
+float LatencyHistogram::get_percentile_ms(float percentile) const
+{
+    if (m_count == 0) return 0.0f;
+
+    uint64_t target = (uint64_t)(percentile / 100.0f * m_count);
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++)
+    {
+        seen += m_buckets[bucket];
+        if (seen > target) return (bucket + 1) * LATENCY_BUCKET_NS / 1000000.0f;
+    }
+    return m_max_ns / 1000000.0f;
+}
+
+void LatencyHistogram::print() const
+{
+    if (m_count == 0)
+    {
+        printf("No frames presented\n");
+        return;
+    }
+
+    printf("Input to present latency over %llu frames: mean %.2f ms, p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.2f ms\n",
+        (unsigned long long)m_count, m_total_ns / (double)m_count / 1000000.0,
+        get_percentile_ms(50.0f), get_percentile_ms(90.0f), get_percentile_ms(99.0f), m_max_ns / 1000000.0);
+
+    // one row per occupied bucket, bars scaled to the fullest one
+    uint32_t fullest = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++)
+    {
+        if (m_buckets[bucket] > fullest) fullest = m_buckets[bucket];
+    }
+    for (int bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++)
+    {
+        if (m_buckets[bucket] == 0) continue;
+
+        int bar = (int)(m_buckets[bucket] * 50ull / fullest);
+        printf("%6.1f ms %s%8u |%.*s\n", bucket * LATENCY_BUCKET_NS / 1000000.0f,
+            bucket == LATENCY_BUCKET_COUNT - 1 ? "+" : " ", m_buckets[bucket], bar,
+            "##################################################");
+    }
+}
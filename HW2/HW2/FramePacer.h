@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+enum FramePacingMode
+{
+    PACING_VSYNC, // swap interval 1, the simulation builds the next frame while the last is drawn
+    PACING_VSYNC_LOCKED, // swap interval 1, and each frame waits for the last one to be presented
+    PACING_ADAPTIVE_VSYNC, // swap interval -1, tears instead of stalling on a late frame
+    PACING_CAPPED, // no vsync, frames started at a fixed rate by sleeping then spinning
+    PACING_UNCAPPED // as fast as possible, frames the render thread can't take are dropped
+};
+
+// Decides when the main loop starts its next frame. Input is sampled at the
+// start of a frame, so waiting up front latches it as late as possible.
+class FramePacer
+{
+private:
+    FramePacingMode m_mode = PACING_VSYNC;
+    uint64_t m_frame_ns = 0;
+    uint64_t m_next_frame_ns = 0;
+
+public:
+    // "vsync", "vsync-locked", "adaptive", "uncapped" or "capped:<fps>"
+    bool parse(const char* description);
+
+    FramePacingMode get_mode() const { return m_mode; }
+    bool uses_vsync() const { return m_mode == PACING_VSYNC || m_mode == PACING_VSYNC_LOCKED || m_mode == PACING_ADAPTIVE_VSYNC; }
+    // every mode but uncapped waits for the render thread, so the simulation
+    // can't outrun the display and burn a core building frames nobody sees
+    bool waits_for_render_thread() const { return m_mode != PACING_UNCAPPED; }
+    // one simulated frame per displayed frame, at the cost of the simulation stalling with the display
+    bool waits_for_present() const { return m_mode == PACING_VSYNC_LOCKED; }
+
+    // call with the context current; adaptive vsync falls back to plain vsync if unsupported
+    void apply_swap_interval() const;
+
+    // capped mode only, sleeps until a couple of milliseconds before the
+    // deadline then spins the rest, since sleeps overshoot by up to a scheduler tick
+    void wait_for_next_frame();
+};
+
+// Input-to-present latency in LATENCY_BUCKET_NS buckets, the last bucket holds everything slower
+const int LATENCY_BUCKET_COUNT = 200;
+const uint64_t LATENCY_BUCKET_NS = 500000;
+
+class LatencyHistogram
+{
+private:
+    uint32_t m_buckets[LATENCY_BUCKET_COUNT] = {};
+    uint64_t m_count = 0;
+    uint64_t m_total_ns = 0;
+    uint64_t m_max_ns = 0;
+
+public:
+    void record(uint64_t latency_ns);
+
+    uint64_t get_count() const { return m_count; }
+    // upper edge of the bucket the percentile falls in, in milliseconds
+    float get_percentile_ms(float percentile) const;
+    void print() const;
+};
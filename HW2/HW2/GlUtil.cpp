@@ -0,0 +1,44 @@
+#include "GlUtil.h"
+#include <cstdio>
+#include <cstring>
+
+bool gl_extension_supported(const char* name)
+{
+    // core profiles only list extensions one at a time
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    if (extensions == NULL)
+    {
+        while (glGetError() != GL_NO_ERROR) {}
+
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), name) == 0) return true;
+        }
+        return false;
+    }
+
+    // whole words only, GL_EXT_foo must not match GL_EXT_foo_bar
+    size_t length = strlen(name);
+    for (const char* found = strstr(extensions, name); found != NULL; found = strstr(found + length, name))
+    {
+        bool starts_word = found == extensions || found[-1] == ' ';
+        bool ends_word = found[length] == ' ' || found[length] == '\0';
+        if (starts_word && ends_word) return true;
+    }
+    return false;
+}
+
+int gl_version()
+{
+    const char* version = (const char*)glGetString(GL_VERSION);
+    int major = 0, minor = 0;
+    if (version == NULL) return 0;
+
+    // "OpenGL ES 3.2 ..." on ES, "4.6 (Compatibility Profile) Mesa ..." on desktop
+    const char* digits = version;
+    while (*digits != '\0' && (*digits < '0' || *digits > '9')) digits++;
+    if (sscanf(digits, "%d.%d", &major, &minor) != 2) return 0;
+    return major * 10 + minor;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+
+// KHR_parallel_shader_compile, which older glext.h and the macOS headers don't have
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// asks the current context directly, so it also works without an SDL window
+bool gl_extension_supported(const char* name);
+
+// major * 10 + minor of the current context, e.g. 33 for OpenGL 3.3
+int gl_version();
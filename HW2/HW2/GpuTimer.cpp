@@ -0,0 +1,107 @@
+#define GL_SILENCE_DEPRECATION
+
+#include "GpuTimer.h"
+#include "GlUtil.h"
+#include "Profiler.h"
+#include <cstdio>
+
+void GpuTimer::initialise()
+{
+    m_supported = gl_version() >= 33 ||
+                  gl_extension_supported("GL_ARB_timer_query") ||
+                  gl_extension_supported("GL_EXT_timer_query");
+    if (!m_supported)
+    {
+        printf("GPU timer queries not supported, GPU timing disabled\n");
+        return;
+    }
+
+    glGenQueries(GPU_TIMER_FRAME_LATENCY * GPU_TIMER_MAX_PASSES, &m_queries[0][0]);
+    for (int slot = 0; slot < GPU_TIMER_FRAME_LATENCY; slot++) m_pass_count[slot] = 0;
+
+    m_profiler_track = profiler_create_track("GPU");
+}
+
+void GpuTimer::shutdown()
+{
+    if (!m_supported) return;
+    glDeleteQueries(GPU_TIMER_FRAME_LATENCY * GPU_TIMER_MAX_PASSES, &m_queries[0][0]);
+    m_supported = false;
+}
+
+// reads back the frame issued GPU_TIMER_FRAME_LATENCY frames ago, before its
+// slot is reused; if the GPU is even further behind the results are dropped
+// rather than waited for
+void GpuTimer::collect(int slot)
+{
+    int count = m_pass_count[slot];
+    m_pass_count[slot] = 0;
+    if (count == 0) return;
+
+    GLint available = 0;
+    glGetQueryObjectiv(m_queries[slot][count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+
+    for (int pass = 0; pass < count; pass++)
+    {
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(m_queries[slot][pass], GL_QUERY_RESULT, &elapsed_ns);
+
+        m_last_names[pass] = m_pass_names[slot][pass];
+        m_last_ms[pass] = elapsed_ns / 1000000.0;
+
+        // GL_TIME_ELAPSED has no absolute start, so the GPU zone is anchored
+        // at the CPU time the pass was submitted
+        uint64_t start_ns = m_pass_cpu_ns[slot][pass];
+        if (profiler_is_enabled())
+            profiler_record_on_track(m_profiler_track, m_pass_names[slot][pass], start_ns, start_ns + elapsed_ns);
+    }
+    m_last_count = count;
+}
+
+void GpuTimer::begin_frame()
+{
+    if (!m_supported) return;
+    collect(m_frame % GPU_TIMER_FRAME_LATENCY);
+}
+
+void GpuTimer::begin_pass(const char* name)
+{
+    if (!m_supported) return;
+
+    int slot = m_frame % GPU_TIMER_FRAME_LATENCY;
+    int pass = m_pass_count[slot];
+    if (m_pass_open || pass == GPU_TIMER_MAX_PASSES) return;
+
+    m_pass_names[slot][pass] = name;
+    m_pass_cpu_ns[slot][pass] = profiler_now_ns();
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[slot][pass]);
+    m_pass_open = true;
+}
+
+void GpuTimer::end_pass()
+{
+    if (!m_supported || !m_pass_open) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pass_count[m_frame % GPU_TIMER_FRAME_LATENCY]++;
+    m_pass_open = false;
+}
+
+void GpuTimer::end_frame()
+{
+    if (!m_supported) return;
+    end_pass();
+    m_frame++;
+}
+
+void GpuTimer::format_summary(char* buffer, int buffer_size) const
+{
+    int written = 0;
+    buffer[0] = '\0';
+    for (int pass = 0; pass < m_last_count && written < buffer_size; pass++)
+    {
+        written += snprintf(buffer + written, buffer_size - written, "%s%s %.3f ms",
+            pass == 0 ? "" : " | ", m_last_names[pass], m_last_ms[pass]);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include "Profiler.h"
+
+// frames of queries kept in flight. end_frame() only moves on to the next
+// slot; frame N's queries are read back by frame N + GPU_TIMER_FRAME_LATENCY's
+// begin_frame(), before it reuses their slot. With 3 slots that is two whole
+// frames after they were issued, so reading them never stalls the pipeline.
+const int GPU_TIMER_FRAME_LATENCY = 3;
+const int GPU_TIMER_MAX_PASSES = 8;
+
+// Times render passes on the GPU with GL_TIME_ELAPSED queries. Passes can't
+// nest (only one GL_TIME_ELAPSED query may be active), so wrap them one after
+// another between begin_frame() and end_frame().
+class GpuTimer
+{
+private:
+    bool m_supported = false;
+    bool m_pass_open = false;
+    int m_frame = 0;
+
+    GLuint m_queries[GPU_TIMER_FRAME_LATENCY][GPU_TIMER_MAX_PASSES];
+    const char* m_pass_names[GPU_TIMER_FRAME_LATENCY][GPU_TIMER_MAX_PASSES];
+    uint64_t m_pass_cpu_ns[GPU_TIMER_FRAME_LATENCY][GPU_TIMER_MAX_PASSES];
+    int m_pass_count[GPU_TIMER_FRAME_LATENCY];
+
+    // most recent resolved frame, for the overlay
+    const char* m_last_names[GPU_TIMER_MAX_PASSES];
+    double m_last_ms[GPU_TIMER_MAX_PASSES];
+    int m_last_count = 0;
+
+    ThreadBuffer* m_profiler_track = nullptr;
+
+    void collect(int slot);
+
+public:
+    // needs a current GL context with ARB_timer_query (GL 3.3) or EXT_timer_query
+    void initialise();
+    void shutdown();
+
+    void begin_frame();
+    void begin_pass(const char* name);
+    void end_pass();
+    void end_frame();
+
+    bool is_supported() const { return m_supported; }
+
+    // "clear 0.01 ms | sprites 0.12 ms | ..." for the last frame with results
+    void format_summary(char* buffer, int buffer_size) const;
+};
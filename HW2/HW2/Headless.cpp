@@ -0,0 +1,164 @@
+#include "Headless.h"
+#include "GlUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+static EGLDisplay g_egl_display = EGL_NO_DISPLAY;
+static EGLContext g_egl_context = EGL_NO_CONTEXT;
+#endif
+
+static GLuint g_framebuffer = 0;
+static GLuint g_colour_renderbuffer = 0;
+static int g_width = 0,
+g_height = 0;
+
+#ifdef __linux__
+static EGLDisplay open_display()
+{
+    // prefer a display that needs no window system at all
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (get_platform_display != NULL)
+    {
+        EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) return display;
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, NULL, NULL)) return display;
+    return EGL_NO_DISPLAY;
+}
+#endif
+
+bool headless_initialise(int width, int height)
+{
+#ifdef __linux__
+    g_egl_display = open_display();
+    if (g_egl_display == EGL_NO_DISPLAY)
+    {
+        printf("Headless: no EGL display\n");
+        return false;
+    }
+
+    // no surface type, there's nothing to draw to but the framebuffer object
+    const EGLint config_attributes[] = { EGL_SURFACE_TYPE, 0, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config;
+    EGLint config_count = 0;
+    if (!eglBindAPI(EGL_OPENGL_API) ||
+        !eglChooseConfig(g_egl_display, config_attributes, &config, 1, &config_count) || config_count == 0)
+    {
+        printf("Headless: no desktop OpenGL config\n");
+        headless_shutdown();
+        return false;
+    }
+
+    // a compatibility context, the game still draws from client-side arrays
+    g_egl_context = eglCreateContext(g_egl_display, config, EGL_NO_CONTEXT, NULL);
+    if (g_egl_context == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(g_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, g_egl_context))
+    {
+        printf("Headless: unable to make a surfaceless context current\n");
+        headless_shutdown();
+        return false;
+    }
+
+    g_width = width;
+    g_height = height;
+
+    glGenRenderbuffers(1, &g_colour_renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, g_colour_renderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenFramebuffers(1, &g_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, g_colour_renderbuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        printf("Headless: framebuffer incomplete\n");
+        headless_shutdown();
+        return false;
+    }
+
+    printf("Headless: %s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    return true;
+#else
+    (void)width;
+    (void)height;
+    printf("Headless: only supported on Linux with EGL\n");
+    return false;
+#endif
+}
+
+void headless_shutdown()
+{
+#ifdef __linux__
+    if (g_egl_context != EGL_NO_CONTEXT)
+    {
+        glDeleteFramebuffers(1, &g_framebuffer);
+        glDeleteRenderbuffers(1, &g_colour_renderbuffer);
+        g_framebuffer = 0;
+        g_colour_renderbuffer = 0;
+
+        eglMakeCurrent(g_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(g_egl_display, g_egl_context);
+        g_egl_context = EGL_NO_CONTEXT;
+    }
+    if (g_egl_display != EGL_NO_DISPLAY)
+    {
+        eglTerminate(g_egl_display);
+        g_egl_display = EGL_NO_DISPLAY;
+    }
+#endif
+}
+
+void headless_read_pixels(std::vector<uint8_t>& rgb)
+{
+    rgb.resize((size_t)g_width * g_height * 3);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, g_width, g_height, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+
+    // GL reads bottom row first
+    size_t row_size = (size_t)g_width * 3;
+    std::vector<uint8_t> row(row_size);
+    for (int y = 0; y < g_height / 2; y++)
+    {
+        uint8_t* top = &rgb[y * row_size];
+        uint8_t* bottom = &rgb[(g_height - 1 - y) * row_size];
+        std::copy(top, top + row_size, row.begin());
+        std::copy(bottom, bottom + row_size, top);
+        std::copy(row.begin(), row.end(), bottom);
+    }
+}
+
+bool write_ppm(const char* filepath, int width, int height, const std::vector<uint8_t>& rgb)
+{
+    FILE* file = fopen(filepath, "wb");
+    if (file == NULL) return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    bool written = fwrite(rgb.data(), 1, rgb.size(), file) == rgb.size();
+    return fclose(file) == 0 && written;
+}
+
+bool read_ppm(const char* filepath, int& width, int& height, std::vector<uint8_t>& rgb)
+{
+    FILE* file = fopen(filepath, "rb");
+    if (file == NULL) return false;
+
+    int max_value = 0;
+    bool valid = fscanf(file, "P6 %d %d %d", &width, &height, &max_value) == 3 &&
+        max_value == 255 && width > 0 && height > 0 && fgetc(file) != EOF;
+    if (valid)
+    {
+        rgb.resize((size_t)width * height * 3);
+        valid = fread(rgb.data(), 1, rgb.size(), file) == rgb.size();
+    }
+
+    fclose(file);
+    return valid;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Offscreen OpenGL without a window, for CI machines with no display or GPU.
+// The context comes from EGL's surfaceless platform (Mesa llvmpipe works) and
+// everything is drawn into a framebuffer object of the requested size, which
+// stays bound. Only available on Linux builds.
+bool headless_initialise(int width, int height);
+void headless_shutdown();
+
+// the framebuffer as tightly packed RGB rows, top row first
+void headless_read_pixels(std::vector<uint8_t>& rgb);
+
+// binary PPM (P6) images for golden image tests
+bool write_ppm(const char* filepath, int width, int height, const std::vector<uint8_t>& rgb);
+bool read_ppm(const char* filepath, int& width, int& height, std::vector<uint8_t>& rgb);
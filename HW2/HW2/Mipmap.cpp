@@ -0,0 +1,150 @@
+#include "Mipmap.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIPMAP_USE_SSE2 1
+#endif
+
+#ifdef MIPMAP_USE_SSE2
+static inline __m128 load_pixel(const uint8_t* pixel)
+{
+    int packed;
+    memcpy(&packed, pixel, sizeof(packed));
+    __m128i zero = _mm_setzero_si128();
+    __m128i channels = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+    return _mm_cvtepi32_ps(channels);
+}
+
+static inline __m128 broadcast_alpha(__m128 pixel)
+{
+    return _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// one pixel's four channels per register, same arithmetic as the scalar path
+static inline void downsample_pixel(const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, const uint8_t* p3,
+    uint8_t* destination)
+{
+    __m128 pixel0 = load_pixel(p0), pixel1 = load_pixel(p1), pixel2 = load_pixel(p2), pixel3 = load_pixel(p3);
+    __m128 alpha0 = broadcast_alpha(pixel0), alpha1 = broadcast_alpha(pixel1),
+        alpha2 = broadcast_alpha(pixel2), alpha3 = broadcast_alpha(pixel3);
+    __m128 alpha_sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(alpha0, alpha1), alpha2), alpha3);
+
+    // fully transparent: weight every pixel the same
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 transparent = _mm_cmpeq_ps(alpha_sum, _mm_setzero_ps());
+    alpha0 = _mm_or_ps(_mm_andnot_ps(transparent, alpha0), _mm_and_ps(transparent, one));
+    alpha1 = _mm_or_ps(_mm_andnot_ps(transparent, alpha1), _mm_and_ps(transparent, one));
+    alpha2 = _mm_or_ps(_mm_andnot_ps(transparent, alpha2), _mm_and_ps(transparent, one));
+    alpha3 = _mm_or_ps(_mm_andnot_ps(transparent, alpha3), _mm_and_ps(transparent, one));
+
+    __m128 weighted = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pixel0, alpha0), _mm_mul_ps(pixel1, alpha1)),
+        _mm_mul_ps(pixel2, alpha2)), _mm_mul_ps(pixel3, alpha3));
+    __m128 weight_sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(alpha0, alpha1), alpha2), alpha3);
+    __m128 colour = _mm_div_ps(weighted, weight_sum);
+
+    // alpha itself is a plain average
+    __m128 alpha_lane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+    __m128 alpha = _mm_mul_ps(alpha_sum, _mm_set1_ps(0.25f));
+    __m128 result = _mm_or_ps(_mm_andnot_ps(alpha_lane, colour), _mm_and_ps(alpha_lane, alpha));
+
+    __m128i rounded = _mm_cvttps_epi32(_mm_add_ps(result, _mm_set1_ps(0.5f)));
+    rounded = _mm_packs_epi32(rounded, rounded);
+    int packed = _mm_cvtsi128_si32(_mm_packus_epi16(rounded, rounded));
+    memcpy(destination, &packed, sizeof(packed));
+}
+#else
+static inline void downsample_pixel(const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, const uint8_t* p3,
+    uint8_t* destination)
+{
+    float alpha0 = p0[3], alpha1 = p1[3], alpha2 = p2[3], alpha3 = p3[3];
+    float alpha_sum = alpha0 + alpha1 + alpha2 + alpha3;
+
+    // fully transparent: weight every pixel the same
+    if (alpha_sum == 0.0f) alpha0 = alpha1 = alpha2 = alpha3 = 1.0f;
+    float weight_sum = alpha0 + alpha1 + alpha2 + alpha3;
+
+    for (int c = 0; c < 3; c++)
+    {
+        float weighted = p0[c] * alpha0 + p1[c] * alpha1 + p2[c] * alpha2 + p3[c] * alpha3;
+        destination[c] = (uint8_t)(int)(weighted / weight_sum + 0.5f);
+    }
+    destination[3] = (uint8_t)(int)(alpha_sum * 0.25f + 0.5f);
+}
+#endif
+
+// any footprint up to 3x3 at (x, y), for the texels on odd edges; shared by
+// both builds so their results stay identical
+static void downsample_footprint(const uint8_t* source, int source_width, int x, int y, int columns, int rows,
+    uint8_t* destination)
+{
+    float alpha_sum = 0.0f;
+    for (int j = 0; j < rows; j++)
+    {
+        for (int i = 0; i < columns; i++) alpha_sum += source[((size_t)(y + j) * source_width + x + i) * 4 + 3];
+    }
+
+    // fully transparent: weight every pixel the same
+    float weighted[3] = { 0.0f, 0.0f, 0.0f };
+    float weight_sum = 0.0f;
+    for (int j = 0; j < rows; j++)
+    {
+        for (int i = 0; i < columns; i++)
+        {
+            const uint8_t* pixel = &source[((size_t)(y + j) * source_width + x + i) * 4];
+            float weight = alpha_sum == 0.0f ? 1.0f : pixel[3];
+            for (int c = 0; c < 3; c++) weighted[c] += pixel[c] * weight;
+            weight_sum += weight;
+        }
+    }
+
+    for (int c = 0; c < 3; c++) destination[c] = (uint8_t)(int)(weighted[c] / weight_sum + 0.5f);
+    destination[3] = (uint8_t)(int)(alpha_sum / (float)(columns * rows) + 0.5f);
+}
+
+// pixels the texel at index takes in along a side: 1 on a side already 1 wide,
+// 3 for the last texel of an odd side, 2 otherwise
+static int footprint_size(int index, int size, int source_size)
+{
+    if (source_size == 1) return 1;
+    return index == size - 1 && (source_size & 1) != 0 ? 3 : 2;
+}
+
+void downsample_rgba8(const uint8_t* source, int source_width, int source_height, uint8_t* destination)
+{
+    int width = source_width > 1 ? source_width / 2 : 1,
+        height = source_height > 1 ? source_height / 2 : 1;
+
+    for (int y = 0; y < height; y++)
+    {
+        int rows = footprint_size(y, height, source_height);
+        const uint8_t* row0 = source + (size_t)(y * 2) * source_width * 4;
+        const uint8_t* row1 = row0 + (size_t)source_width * 4;
+        uint8_t* out = destination + (size_t)y * width * 4;
+
+        for (int x = 0; x < width; x++)
+        {
+            int columns = footprint_size(x, width, source_width);
+            if (rows == 2 && columns == 2)
+            {
+                int x0 = x * 2 * 4, x1 = x0 + 4;
+                downsample_pixel(row0 + x0, row0 + x1, row1 + x0, row1 + x1, out + x * 4);
+            }
+            else downsample_footprint(source, source_width, x * 2, y * 2, columns, rows, out + x * 4);
+        }
+    }
+}
+
+void build_mip_chain(TextureData& texture)
+{
+    for (size_t i = 0; texture.levels[i].width > 1 || texture.levels[i].height > 1; i++)
+    {
+        TextureLevel source = texture.levels[i];
+        int width = source.width > 1 ? source.width / 2 : 1,
+            height = source.height > 1 ? source.height / 2 : 1;
+
+        // adding the level may move the data, so take pointers after
+        texture.add_level(width, height, (size_t)width * height * 4);
+        downsample_rgba8(&texture.data[source.offset], source.width, source.height, &texture.data[texture.levels.back().offset]);
+    }
+}
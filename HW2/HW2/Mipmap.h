@@ -0,0 +1,15 @@
+#pragma once
+
+#include "TextureFile.h"
+#include <cstdint>
+
+// Adds the rest of the mip chain to an uncompressed RGBA8 texture holding just
+// level 0: each level is a 2x2 box filter of the one above, down to 1x1. On an
+// odd side the last texel also takes in the leftover row or column, averaging
+// 3 pixels that way, so nothing is dropped. Colours are weighted by alpha, so
+// the arbitrary colour of transparent pixels doesn't bleed into sprite edges.
+// Uses SSE2 where available; the scalar path gives identical results.
+void build_mip_chain(TextureData& texture);
+
+// one level; destination holds max(width / 2, 1) x max(height / 2, 1) pixels
+void downsample_rgba8(const uint8_t* source, int source_width, int source_height, uint8_t* destination);
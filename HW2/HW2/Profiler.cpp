@@ -0,0 +1,180 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum ProfileEventType
+{
+    PROFILE_EVENT_ZONE,
+    PROFILE_EVENT_COUNTER
+};
+
+// counters keep their value in end_ns
+struct ProfileEvent
+{
+    const char* name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint32_t type;
+};
+
+struct ThreadBuffer
+{
+    uint32_t thread_id;
+    std::string thread_name;
+    std::atomic<uint64_t> write_count{ 0 };
+    std::unique_ptr<ProfileEvent[]> events; // allocated by the first write, by the writing thread
+};
+
+static std::atomic<bool> g_profiler_enabled{ false };
+
+// buffers are registered once per thread and kept alive after the thread
+// exits, so zones from finished worker threads still make it into the trace
+static std::mutex g_buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+
+static thread_local ThreadBuffer* t_buffer = nullptr;
+
+// callers must hold g_buffers_mutex
+static ThreadBuffer* create_buffer()
+{
+    g_buffers.emplace_back(new ThreadBuffer());
+    ThreadBuffer* buffer = g_buffers.back().get();
+    buffer->thread_id = (uint32_t)g_buffers.size();
+    buffer->thread_name = "thread " + std::to_string(buffer->thread_id);
+    return buffer;
+}
+
+static ThreadBuffer* get_thread_buffer()
+{
+    if (t_buffer == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(g_buffers_mutex);
+        t_buffer = create_buffer();
+    }
+    return t_buffer;
+}
+
+static void write_event(ThreadBuffer* buffer, const char* name, uint64_t start_ns, uint64_t end_ns,
+    ProfileEventType type = PROFILE_EVENT_ZONE)
+{
+    if (!buffer->events) buffer->events.reset(new ProfileEvent[PROFILER_RING_SIZE]);
+
+    uint64_t index = buffer->write_count.load(std::memory_order_relaxed);
+    ProfileEvent& event = buffer->events[index % PROFILER_RING_SIZE];
+    event.name = name;
+    event.start_ns = start_ns;
+    event.end_ns = end_ns;
+    event.type = type;
+    buffer->write_count.store(index + 1, std::memory_order_release);
+}
+
+uint64_t profiler_now_ns()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    // + 1 so a real timestamp is never 0, which ProfileZone uses for "not recording"
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count() + 1;
+}
+
+void profiler_set_enabled(bool enabled)
+{
+    profiler_now_ns(); // pin the epoch before the first zone
+    g_profiler_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool profiler_is_enabled()
+{
+    return g_profiler_enabled.load(std::memory_order_relaxed);
+}
+
+void profiler_set_thread_name(const char* name)
+{
+    ThreadBuffer* buffer = get_thread_buffer();
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    buffer->thread_name = name;
+}
+
+void profiler_record(const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+    write_event(get_thread_buffer(), name, start_ns, end_ns);
+}
+
+void profiler_record_counter(const char* name, int64_t value)
+{
+    if (!profiler_is_enabled()) return;
+    write_event(get_thread_buffer(), name, profiler_now_ns(), (uint64_t)value, PROFILE_EVENT_COUNTER);
+}
+
+ThreadBuffer* profiler_create_track(const char* name)
+{
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    ThreadBuffer* buffer = create_buffer();
+    buffer->thread_name = name;
+    return buffer;
+}
+
+void profiler_record_on_track(ThreadBuffer* track, const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+    write_event(track, name, start_ns, end_ns);
+}
+
+// zone names are string literals, but escape them anyway so the JSON stays valid
+static void write_json_string(FILE* file, const char* text)
+{
+    fputc('"', file);
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+bool profiler_write_chrome_trace(const char* filepath)
+{
+    FILE* file = fopen(filepath, "w");
+    if (file == NULL) return false;
+
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : g_buffers)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+            first ? "" : ",\n", buffer->thread_id);
+        write_json_string(file, buffer->thread_name.c_str());
+        fprintf(file, "}}");
+        first = false;
+
+        // only the newest PROFILER_RING_SIZE zones survive in the ring
+        uint64_t count = buffer->write_count.load(std::memory_order_acquire);
+        uint64_t begin = count > PROFILER_RING_SIZE ? count - PROFILER_RING_SIZE : 0;
+        for (uint64_t i = begin; i < count; i++)
+        {
+            const ProfileEvent& event = buffer->events[i % PROFILER_RING_SIZE];
+            fprintf(file, ",\n{\"name\":");
+            write_json_string(file, event.name);
+            if (event.type == PROFILE_EVENT_COUNTER)
+            {
+                fprintf(file, ",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                    buffer->thread_id, event.start_ns / 1000.0, (long long)(int64_t)event.end_ns);
+            }
+            else
+            {
+                fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->thread_id, event.start_ns / 1000.0, (event.end_ns - event.start_ns) / 1000.0);
+            }
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    fclose(file);
+    return true;
+}
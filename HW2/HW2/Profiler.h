@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+// Scoped CPU zone profiler. Each thread records into its own ring buffer of
+// PROFILER_RING_SIZE zones, allocated with its first zone, so recording never
+// takes a lock; when profiling is off a zone costs one relaxed atomic load and
+// no memory. Build with DISABLE_PROFILER to compile the zones out entirely.
+//
+//     void update()
+//     {
+//         PROFILE_ZONE("update");
+//         ...
+//     }
+
+const uint32_t PROFILER_RING_SIZE = 1 << 16;
+
+uint64_t profiler_now_ns();
+
+void profiler_set_enabled(bool enabled);
+bool profiler_is_enabled();
+
+// names the calling thread's track in the trace
+void profiler_set_thread_name(const char* name);
+
+// records a finished zone on the calling thread, name must outlive the profiler
+void profiler_record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+// records a value on the calling thread's timeline, shown as a graph in the trace viewer
+void profiler_record_counter(const char* name, int64_t value);
+
+// extra tracks for timelines that don't belong to a CPU thread, like the GPU;
+// each track must only be written from one thread at a time
+struct ThreadBuffer;
+ThreadBuffer* profiler_create_track(const char* name);
+void profiler_record_on_track(ThreadBuffer* track, const char* name, uint64_t start_ns, uint64_t end_ns);
+
+// writes every thread's recorded zones as Chrome trace JSON (chrome://tracing, Perfetto)
+// call it once the recording threads are idle, e.g. at shutdown
+bool profiler_write_chrome_trace(const char* filepath);
+
+class ProfileZone
+{
+private:
+    const char* m_name;
+    uint64_t m_start_ns;
+
+public:
+    explicit ProfileZone(const char* name)
+        : m_name(name), m_start_ns(profiler_is_enabled() ? profiler_now_ns() : 0) {}
+
+    ~ProfileZone()
+    {
+        if (m_start_ns != 0) profiler_record(m_name, m_start_ns, profiler_now_ns());
+    }
+};
+
+#ifdef DISABLE_PROFILER
+#define PROFILE_ZONE(name) ((void)0)
+#else
+#define PROFILE_ZONE_CONCAT_(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CONCAT(profile_zone_, __LINE__)(name)
+#endif
@@ -0,0 +1,109 @@
+#define GL_SILENCE_DEPRECATION
+
+#include "ProgramCache.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+const char PROGRAM_CACHE_MAGIC[4] = { 'H', 'W', '2', 'P' };
+const uint32_t PROGRAM_CACHE_VERSION = 1;
+
+struct ProgramCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t binary_format;
+    uint32_t binary_length;
+};
+
+static void hash_bytes(uint64_t& hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+}
+
+// includes the terminator so "ab" + "c" and "a" + "bc" differ
+static void hash_string(uint64_t& hash, const char* string)
+{
+    if (string == NULL) string = "";
+    hash_bytes(hash, string, strlen(string) + 1);
+}
+
+bool program_cache_is_supported()
+{
+    if (gl_version() < 41 && !gl_extension_supported("GL_ARB_get_program_binary")) return false;
+
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    return format_count > 0;
+}
+
+uint64_t program_cache_key(const std::string& vertex_source, const std::string& fragment_source)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash_string(hash, vertex_source.c_str());
+    hash_string(hash, fragment_source.c_str());
+    hash_string(hash, (const char*)glGetString(GL_VENDOR));
+    hash_string(hash, (const char*)glGetString(GL_RENDERER));
+    hash_string(hash, (const char*)glGetString(GL_VERSION));
+    return hash;
+}
+
+bool program_cache_load(const char* filepath, uint64_t key, GLuint program)
+{
+    FILE* file = fopen(filepath, "rb");
+    if (file == NULL) return false;
+
+    ProgramCacheHeader header;
+    std::vector<uint8_t> binary;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC)) == 0 &&
+        header.version == PROGRAM_CACHE_VERSION && header.key == key && header.binary_length > 0;
+    if (valid)
+    {
+        binary.resize(header.binary_length);
+        valid = fread(binary.data(), 1, binary.size(), file) == binary.size();
+    }
+    fclose(file);
+    if (!valid) return false;
+
+    // drivers may still refuse it, e.g. after an update that kept the version string
+    glProgramBinary(program, header.binary_format, binary.data(), (GLsizei)binary.size());
+    GLint link_success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &link_success);
+    return link_success == GL_TRUE;
+}
+
+void program_cache_prepare(GLuint program)
+{
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool program_cache_save(const char* filepath, uint64_t key, GLuint program)
+{
+    GLint binary_length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+    if (binary_length <= 0) return false;
+
+    std::vector<uint8_t> binary(binary_length);
+    GLenum binary_format = 0;
+    glGetProgramBinary(program, binary_length, &binary_length, &binary_format, binary.data());
+
+    ProgramCacheHeader header;
+    memcpy(header.magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC));
+    header.version = PROGRAM_CACHE_VERSION;
+    header.key = key;
+    header.binary_format = binary_format;
+    header.binary_length = (uint32_t)binary_length;
+
+    FILE* file = fopen(filepath, "wb");
+    if (file == NULL) return false;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(binary.data(), 1, (size_t)binary_length, file) == (size_t)binary_length;
+    return fclose(file) == 0 && written;
+}
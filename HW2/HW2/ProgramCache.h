@@ -0,0 +1,25 @@
+#pragma once
+
+#include "GlUtil.h"
+#include <cstdint>
+#include <string>
+
+// On-disk cache of linked shader programs (ARB_get_program_binary, GL 4.1), so
+// later launches read a file instead of compiling GLSL. A binary only works
+// with the driver that produced it, so the key covers both shader sources and
+// the GL vendor, renderer and version; anything stale or rejected by the driver
+// just means compiling as usual.
+
+// needs a current GL context, false if the driver offers no binary formats
+bool program_cache_is_supported();
+
+uint64_t program_cache_key(const std::string& vertex_source, const std::string& fragment_source);
+
+// links program from the cached binary, false if it's missing, stale or rejected
+bool program_cache_load(const char* filepath, uint64_t key, GLuint program);
+
+// call before glLinkProgram so the driver keeps the binary around
+void program_cache_prepare(GLuint program);
+
+// saves a linked program's binary under key
+bool program_cache_save(const char* filepath, uint64_t key, GLuint program);
@@ -0,0 +1,95 @@
+#include "RenderThread.h"
+#include "Profiler.h"
+
+void RenderThread::start(SDL_Window* window, SDL_GLContext context, RenderFunction render_function, const FramePacer* pacer)
+{
+    m_pacer = pacer;
+    m_window = window;
+    m_context = context;
+    m_render_function = render_function;
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+void RenderThread::stop()
+{
+    if (!m_thread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.store(false, std::memory_order_release);
+    }
+    m_frame_submitted.notify_all();
+    m_frame_taken.notify_all();
+    m_thread.join();
+}
+
+bool RenderThread::submit(const RenderFrame& frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_frames.try_push(frame)) return false;
+        m_submitted_count++;
+    }
+    m_frame_submitted.notify_one();
+    return true;
+}
+
+void RenderThread::wait_for_free_slot()
+{
+    PROFILE_ZONE("wait_for_free_slot");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_frame_taken.wait(lock, [this]()
+    {
+        return m_taken_count == m_submitted_count || !m_running.load(std::memory_order_acquire);
+    });
+}
+
+void RenderThread::wait_for_present()
+{
+    PROFILE_ZONE("wait_for_present");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_frame_taken.wait(lock, [this]()
+    {
+        return m_retired_count == m_submitted_count || !m_running.load(std::memory_order_acquire);
+    });
+}
+
+void RenderThread::run()
+{
+    profiler_set_thread_name("render");
+    SDL_GL_MakeCurrent(m_window, m_context);
+    if (m_pacer != NULL) m_pacer->apply_swap_interval();
+
+    RenderFrame frame;
+    while (true)
+    {
+        // skip ahead to the newest frame
+        uint64_t popped = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frame_submitted.wait(lock, [this]()
+            {
+                return !m_frames.empty() || !m_running.load(std::memory_order_acquire);
+            });
+            if (!m_running.load(std::memory_order_acquire)) break;
+
+            while (m_frames.try_pop(frame)) popped++;
+            m_taken_count += popped;
+        }
+        m_frame_taken.notify_one();
+
+        m_render_function(frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_retired_count += popped;
+        }
+        m_frame_taken.notify_one();
+    }
+
+    SDL_GL_MakeCurrent(m_window, NULL);
+}
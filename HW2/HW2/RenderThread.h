@@ -0,0 +1,89 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "glm/mat4x4.hpp"
+#include "SpscQueue.h"
+#include "FramePacer.h"
+
+const int MAX_SPRITE_COMMANDS = 16;
+
+struct SpriteCommand
+{
+    glm::mat4 model_matrix;
+    uint32_t texture; // handle, see TextureResidency
+};
+
+// everything the render thread needs to draw one frame, copied out of the simulation
+struct RenderFrame
+{
+    SpriteCommand sprites[MAX_SPRITE_COMMANDS];
+    int sprite_count = 0;
+    uint64_t input_time_ns = 0; // when the oldest input this frame applies arrived, 0 if it applies none
+
+    void add_sprite(const glm::mat4& model_matrix, uint32_t texture)
+    {
+        if (sprite_count == MAX_SPRITE_COMMANDS) return;
+        sprites[sprite_count].model_matrix = model_matrix;
+        sprites[sprite_count].texture = texture;
+        sprite_count++;
+    }
+};
+
+// Owns the GL context on its own thread and draws the frames the simulation
+// submits. The queue holds two frames; when the render thread falls behind
+// (vsync, driver stalls) submit() drops the frame instead of blocking, and the
+// render thread always draws the newest frame it has. Both sides sleep on
+// condition variables rather than spinning: the render thread until a frame
+// arrives, the simulation (through the wait functions) until one retires.
+class RenderThread
+{
+public:
+    typedef void (*RenderFunction)(const RenderFrame& frame);
+
+private:
+    SDL_Window* m_window = NULL;
+    SDL_GLContext m_context = NULL;
+    RenderFunction m_render_function = NULL;
+    const FramePacer* m_pacer = NULL;
+
+    SpscQueue<RenderFrame, 2> m_frames;
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+
+    // the counts and m_running change under m_mutex so neither side misses a wakeup
+    std::mutex m_mutex;
+    std::condition_variable m_frame_submitted;
+    std::condition_variable m_frame_taken; // notified for both counts below
+    uint64_t m_submitted_count = 0; // frames accepted by submit()
+    uint64_t m_taken_count = 0; // frames popped off the queue
+    uint64_t m_retired_count = 0; // frames drawn, or skipped for a newer one
+
+    void run();
+
+public:
+    // the context must not be current on the calling thread
+    void start(SDL_Window* window, SDL_GLContext context, RenderFunction render_function, const FramePacer* pacer);
+    // waits for the thread to exit; the context is released and can be made current again
+    void stop();
+
+    // called from the simulation thread, returns false if the frame was dropped
+    bool submit(const RenderFrame& frame);
+
+    // The simulation waits on one of these before each frame so it runs no
+    // faster than the display; both return at once once the thread has stopped.
+    // wait_for_free_slot() blocks until the render thread has taken every
+    // submitted frame, so the next frame is built while the last is drawn and
+    // none are skipped. wait_for_present() blocks until every submitted frame
+    // is drawn, for one simulated frame per displayed frame.
+    void wait_for_free_slot();
+    void wait_for_present();
+};
@@ -0,0 +1,113 @@
+#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+
+const char REPLAY_MAGIC[4] = { 'H', 'W', '2', 'R' };
+const uint32_t REPLAY_VERSION = 2;
+
+static void write_uint(std::vector<uint8_t>& out, uint64_t value, int size)
+{
+    for (int i = 0; i < size; i++) out.push_back((uint8_t)(value >> (i * 8)));
+}
+
+static void write_varint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static bool read_uint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value, int size)
+{
+    if (in.size() - pos < (size_t)size) return false;
+    value = 0;
+    for (int i = 0; i < size; i++) value |= (uint64_t)in[pos++] << (i * 8);
+    return true;
+}
+
+static bool read_varint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos == in.size()) return false;
+        uint8_t byte = in[pos++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool replay_save(const char* filepath, const Replay& replay)
+{
+    std::vector<uint8_t> data(REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    write_uint(data, REPLAY_VERSION, 4);
+    write_uint(data, replay.inputs.size(), 4);
+    write_uint(data, replay.final_hash, 8);
+
+    uint8_t previous_input = 0;
+    size_t previous_tick = 0;
+    for (size_t tick = 0; tick < replay.inputs.size(); tick++)
+    {
+        if (replay.inputs[tick] == previous_input) continue;
+
+        write_varint(data, tick - previous_tick);
+        data.push_back(replay.inputs[tick] ^ previous_input);
+        previous_input = replay.inputs[tick];
+        previous_tick = tick;
+    }
+
+    FILE* file = fopen(filepath, "wb");
+    if (file == NULL) return false;
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && written;
+}
+
+bool replay_load(const char* filepath, Replay& replay)
+{
+    FILE* file = fopen(filepath, "rb");
+    if (file == NULL) return false;
+
+    std::vector<uint8_t> data;
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + count);
+    fclose(file);
+
+    size_t pos = sizeof(REPLAY_MAGIC);
+    uint64_t version, tick_count;
+    if (data.size() < pos || memcmp(data.data(), REPLAY_MAGIC, pos) != 0) return false;
+    if (!read_uint(data, pos, version, 4) || version != REPLAY_VERSION) return false;
+    if (!read_uint(data, pos, tick_count, 4) || !read_uint(data, pos, replay.final_hash, 8)) return false;
+
+    replay.inputs.assign(tick_count, 0);
+    uint8_t input = 0;
+    uint64_t tick = 0;
+    while (pos < data.size())
+    {
+        uint64_t run;
+        if (!read_varint(data, pos, run) || pos == data.size()) return false;
+
+        // the current input holds until this change
+        uint64_t change_tick = tick + run;
+        if (change_tick >= tick_count) return false;
+        for (; tick < change_tick; tick++) replay.inputs[tick] = input;
+        input ^= data[pos++];
+    }
+    for (; tick < tick_count; tick++) replay.inputs[tick] = input;
+
+    return true;
+}
+
+uint64_t replay_simulate(const Replay& replay, GameState& final_state)
+{
+    simulation_reset(final_state);
+    for (size_t tick = 0; tick < replay.inputs.size(); tick++)
+    {
+        simulation_step(final_state, replay.inputs[tick]);
+    }
+    return simulation_hash(final_state);
+}
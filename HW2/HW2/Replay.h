@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+// Input log of a match: one input byte per fixed tick plus the hash of the
+// state the match ended in.
+//
+// On disk the log is delta encoded, since inputs change rarely compared with
+// the 240 Hz tick rate:
+//     "HW2R" | version u32 | tick count u32 | final hash u64 | records...
+// where each record is a varint count of ticks since the previous change
+// followed by the new input XOR the old one. All integers are little endian.
+struct Replay
+{
+    std::vector<uint8_t> inputs;
+    uint64_t final_hash = 0;
+};
+
+bool replay_save(const char* filepath, const Replay& replay);
+bool replay_load(const char* filepath, Replay& replay);
+
+// re-simulates the match from the start as fast as possible and returns the final state's hash
+uint64_t replay_simulate(const Replay& replay, GameState& final_state);
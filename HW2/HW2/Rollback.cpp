@@ -0,0 +1,176 @@
+#include "Rollback.h"
+#include "Profiler.h"
+
+static const uint8_t PLAYER_INPUT_MASKS[2] = {
+    INPUT_LEFT_UP | INPUT_LEFT_DOWN,
+    INPUT_RIGHT_UP | INPUT_RIGHT_DOWN
+};
+
+void RollbackSession::start(int local_player, Transport* transport)
+{
+    m_local_player = local_player;
+    m_transport = transport;
+
+    simulation_reset(m_state);
+    m_snapshots.clear();
+    m_tick = 0;
+    m_remote_confirmed_tick = 0;
+    m_remote_ack_tick = 0;
+    m_last_remote_input = 0;
+    m_has_remote_checksum = false;
+    for (RemoteChecksum& checksum : m_remote_checksums) checksum.pending = false;
+    m_rollback_count = 0;
+    m_rollback_ticks = 0;
+    m_desync_count = 0;
+    m_checksums_checked = 0;
+    m_checksums_skipped = 0;
+}
+
+uint8_t RollbackSession::combined_input(uint32_t tick) const
+{
+    return m_local_inputs[tick % ROLLBACK_WINDOW] | m_remote_inputs[tick % ROLLBACK_WINDOW];
+}
+
+// the state before the given tick, if no predicted input went into it
+bool RollbackSession::get_confirmed_state(uint32_t tick, GameState& state) const
+{
+    if (tick > m_remote_confirmed_tick || tick > m_tick) return false;
+    if (tick == m_tick)
+    {
+        state = m_state;
+        return true;
+    }
+    return m_snapshots.load(tick, state);
+}
+
+// takes in the remote player's inputs and finds the earliest tick that was predicted wrong
+void RollbackSession::receive_inputs(uint32_t& rollback_tick)
+{
+    uint8_t remote_mask = PLAYER_INPUT_MASKS[1 - m_local_player];
+
+    InputPacket packet;
+    while (m_transport->receive(packet))
+    {
+        if (packet.ack_tick > m_remote_ack_tick) m_remote_ack_tick = packet.ack_tick;
+        if (!m_has_remote_checksum || packet.checksum_tick > m_remote_checksum_tick)
+        {
+            m_remote_checksum_tick = packet.checksum_tick;
+            m_has_remote_checksum = true;
+
+            // a checksum a whole window old that still hasn't been checked never will be
+            RemoteChecksum& checksum = m_remote_checksums[packet.checksum_tick % ROLLBACK_WINDOW];
+            if (checksum.pending) m_checksums_skipped++;
+            checksum.tick = packet.checksum_tick;
+            checksum.checksum = packet.checksum;
+            checksum.pending = true;
+        }
+
+        for (uint32_t i = 0; i < packet.input_count; i++)
+        {
+            // only accept the next tick in order and no further ahead than the
+            // tick about to run, anything later is resent anyway
+            uint32_t tick = packet.first_tick + i;
+            if (tick != m_remote_confirmed_tick || tick > m_tick) continue;
+
+            uint8_t input = packet.inputs[i] & remote_mask;
+            if (tick < m_tick)
+            {
+                if (m_remote_inputs[tick % ROLLBACK_WINDOW] != input && tick < rollback_tick) rollback_tick = tick;
+            }
+            m_remote_inputs[tick % ROLLBACK_WINDOW] = input;
+            m_last_remote_input = input;
+            m_remote_confirmed_tick++;
+        }
+    }
+
+    // predictions after the confirmed ticks follow the latest real input
+    for (uint32_t tick = m_remote_confirmed_tick; tick < m_tick; tick++)
+    {
+        if (m_remote_inputs[tick % ROLLBACK_WINDOW] != m_last_remote_input)
+        {
+            m_remote_inputs[tick % ROLLBACK_WINDOW] = m_last_remote_input;
+            if (tick < rollback_tick) rollback_tick = tick;
+        }
+    }
+}
+
+// compares the remote player's checksums with the ticks this session has confirmed since
+void RollbackSession::check_desync()
+{
+    for (RemoteChecksum& checksum : m_remote_checksums)
+    {
+        if (!checksum.pending || checksum.tick > m_remote_confirmed_tick || checksum.tick > m_tick) continue;
+
+        GameState confirmed_state;
+        if (get_confirmed_state(checksum.tick, confirmed_state))
+        {
+            m_checksums_checked++;
+            if (simulation_hash(confirmed_state) != checksum.checksum) m_desync_count++;
+        }
+        else m_checksums_skipped++;
+        checksum.pending = false;
+    }
+}
+
+void RollbackSession::send_inputs()
+{
+    // everything the remote player hasn't acknowledged, oldest first
+    uint32_t first_tick = m_remote_ack_tick;
+    if (m_tick - first_tick > ROLLBACK_WINDOW) first_tick = m_tick - ROLLBACK_WINDOW;
+
+    InputPacket packet;
+    packet.first_tick = first_tick;
+    packet.ack_tick = m_remote_confirmed_tick;
+
+    GameState confirmed_state;
+    packet.checksum_tick = m_remote_confirmed_tick < m_tick ? m_remote_confirmed_tick : m_tick;
+    packet.checksum = get_confirmed_state(packet.checksum_tick, confirmed_state) ? simulation_hash(confirmed_state) : 0;
+    packet.input_count = (uint8_t)(m_tick - first_tick);
+    for (uint32_t i = 0; i < packet.input_count; i++)
+    {
+        packet.inputs[i] = m_local_inputs[(first_tick + i) % ROLLBACK_WINDOW];
+    }
+    m_transport->send(packet);
+}
+
+bool RollbackSession::advance(uint8_t local_input)
+{
+    uint32_t rollback_tick = m_tick;
+    receive_inputs(rollback_tick);
+
+    if (rollback_tick < m_tick)
+    {
+        PROFILE_ZONE("rollback");
+
+        // restore and simulate the mispredicted ticks again
+        m_snapshots.load(rollback_tick, m_state);
+        for (uint32_t tick = rollback_tick; tick < m_tick; tick++)
+        {
+            m_snapshots.save(m_state);
+            simulation_step(m_state, combined_input(tick));
+        }
+        m_rollback_count++;
+        m_rollback_ticks += m_tick - rollback_tick;
+    }
+    check_desync();
+
+    // wait rather than overwrite the snapshot of the oldest unconfirmed tick,
+    // or the input of the oldest tick the remote player still needs; their
+    // input for the tick about to run may already be confirmed, so neither
+    // is subtracted from m_tick
+    if (m_tick >= m_remote_confirmed_tick + ROLLBACK_WINDOW - 1 ||
+        m_tick >= m_remote_ack_tick + ROLLBACK_WINDOW - 1)
+    {
+        send_inputs();
+        return false;
+    }
+
+    m_local_inputs[m_tick % ROLLBACK_WINDOW] = local_input & PLAYER_INPUT_MASKS[m_local_player];
+    if (m_tick >= m_remote_confirmed_tick) m_remote_inputs[m_tick % ROLLBACK_WINDOW] = m_last_remote_input;
+    m_snapshots.save(m_state);
+    simulation_step(m_state, combined_input(m_tick));
+    m_tick++;
+
+    send_inputs();
+    return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include "Simulation.h"
+#include "Transport.h"
+
+// History kept for rolling back, sized in 60 Hz display frames; the session
+// stalls rather than predicting further ahead of the remote player than this.
+// 16 frames is 64 ticks, so play carries on with up to about 130 ms one-way
+// latency. Re-simulating all 64 ticks measured about 3 us in an optimised
+// build, so even a full rollback is a tiny part of a frame.
+const int ROLLBACK_WINDOW_FRAMES = 16;
+const int ROLLBACK_TICKS_PER_FRAME = 4; // 240 Hz ticks
+const int ROLLBACK_WINDOW = ROLLBACK_WINDOW_FRAMES * ROLLBACK_TICKS_PER_FRAME;
+static_assert(ROLLBACK_WINDOW <= PACKET_MAX_INPUTS, "a packet must fit the whole rollback window");
+
+// GGPO style rollback for one player of a two-player match. Each tick runs
+// straight away with the remote player's input predicted (their last known
+// input held). When their real input arrives and differs from the prediction,
+// the state is restored from the snapshot before that tick and the ticks
+// since then are simulated again.
+class RollbackSession
+{
+private:
+    int m_local_player = 0; // 0 is the left cowboy, 1 the right
+    Transport* m_transport = nullptr;
+
+    GameState m_state;
+    uint32_t m_tick = 0; // ticks simulated so far
+
+    SnapshotRing<ROLLBACK_WINDOW> m_snapshots; // state before each tick ran
+
+    // indexed by tick % ROLLBACK_WINDOW
+    uint8_t m_local_inputs[ROLLBACK_WINDOW];
+    uint8_t m_remote_inputs[ROLLBACK_WINDOW]; // confirmed or predicted
+
+    uint32_t m_remote_confirmed_tick = 0; // remote inputs received for every tick before this
+    uint32_t m_remote_ack_tick = 0; // local inputs the remote player has received
+    uint8_t m_last_remote_input = 0;
+
+    // the remote player's checksums, each held until this session has confirmed
+    // that tick too; indexed by tick % ROLLBACK_WINDOW
+    struct RemoteChecksum
+    {
+        uint32_t tick;
+        uint64_t checksum;
+        bool pending;
+    };
+    RemoteChecksum m_remote_checksums[ROLLBACK_WINDOW];
+    uint32_t m_remote_checksum_tick = 0; // the latest received
+    bool m_has_remote_checksum = false;
+
+    uint32_t m_rollback_count = 0;
+    uint32_t m_rollback_ticks = 0;
+    uint32_t m_desync_count = 0;
+    uint32_t m_checksums_checked = 0;
+    uint32_t m_checksums_skipped = 0; // their state was gone before they could be checked
+
+    uint8_t combined_input(uint32_t tick) const;
+    bool get_confirmed_state(uint32_t tick, GameState& state) const;
+    void receive_inputs(uint32_t& rollback_tick);
+    void check_desync();
+    void send_inputs();
+
+public:
+    void start(int local_player, Transport* transport);
+
+    // runs the next tick with this player's input, masked to their own bits;
+    // returns false and runs nothing while waiting for the remote player to catch up
+    bool advance(uint8_t local_input);
+
+    const GameState& get_state() const { return m_state; }
+    uint32_t get_tick() const { return m_tick; }
+    uint32_t get_confirmed_tick() const { return m_remote_confirmed_tick; }
+    uint32_t get_rollback_count() const { return m_rollback_count; }
+    uint32_t get_rollback_ticks() const { return m_rollback_ticks; }
+    uint32_t get_desync_count() const { return m_desync_count; }
+    uint32_t get_checksums_checked() const { return m_checksums_checked; }
+    uint32_t get_checksums_skipped() const { return m_checksums_skipped; }
+};
@@ -1,26 +1,98 @@
 #define GL_SILENCE_DEPRECATION
 
 #include "ShaderProgram.h"
+#include "Profiler.h"
+#include "ProgramCache.h"
+#include "GlUtil.h"
+#include <SDL.h>
 
-void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_shader_file) {
+void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_shader_file, const char* binary_cache_path) {
+    PROFILE_ZONE("ShaderProgram::load");
 
+    std::string vertex_source = read_shader_file(vertex_shader_file);
+    std::string fragment_source = read_shader_file(fragment_shader_file);
+
+    // try the binary from the last launch before compiling anything
+    bool use_cache = binary_cache_path != NULL && program_cache_is_supported();
+    uint64_t cache_key = use_cache ? program_cache_key(vertex_source, fragment_source) : 0;
+
+    m_program_id = glCreateProgram();
+    m_vertex_shader = 0;
+    m_fragment_shader = 0;
+    if (use_cache && program_cache_load(binary_cache_path, cache_key, m_program_id))
+    {
+        printf("Shader program loaded from %s\n", binary_cache_path);
+        finish_load();
+        return;
+    }
+    glDeleteProgram(m_program_id);
+
+    load_async(vertex_source, fragment_source);
+    if (finish_load() && use_cache && !program_cache_save(binary_cache_path, cache_key, m_program_id))
+    {
+        printf("Unable to write shader program cache %s\n", binary_cache_path);
+    }
+}
+
+// lets the driver compile on as many threads as it likes; looked up at run
+// time since the headers may not declare it, and only once per context
+static void request_compiler_threads(const char* function_name)
+{
+    static bool requested = false;
+    if (requested) return;
+    requested = true;
+
+    typedef void (APIENTRY* MaxShaderCompilerThreadsFunction)(GLuint count);
+    MaxShaderCompilerThreadsFunction max_shader_compiler_threads =
+        (MaxShaderCompilerThreadsFunction)SDL_GL_GetProcAddress(function_name);
+    if (max_shader_compiler_threads != NULL) max_shader_compiler_threads(0xFFFFFFFF);
+}
+
+void ShaderProgram::load_async(const std::string& vertex_source, const std::string& fragment_source)
+{
+    PROFILE_ZONE("compile_shaders");
+
+    m_parallel_compile = true;
+    if (gl_extension_supported("GL_KHR_parallel_shader_compile")) request_compiler_threads("glMaxShaderCompilerThreadsKHR");
+    else if (gl_extension_supported("GL_ARB_parallel_shader_compile")) request_compiler_threads("glMaxShaderCompilerThreadsARB");
+    else m_parallel_compile = false;
+
+    // no status checks until the link is done, so the driver can compile
+    // both shaders at once instead of one after the other
     // create the vertex shader
-    m_vertex_shader = load_shader_from_file(vertex_shader_file, GL_VERTEX_SHADER);
+    m_vertex_shader = load_shader_from_string(vertex_source, GL_VERTEX_SHADER);
     // create the fragment shader
-    m_fragment_shader = load_shader_from_file(fragment_shader_file, GL_FRAGMENT_SHADER);
+    m_fragment_shader = load_shader_from_string(fragment_source, GL_FRAGMENT_SHADER);
 
     // Create the final shader program from our vertex and fragment shaders
     m_program_id = glCreateProgram();
     glAttachShader(m_program_id, m_vertex_shader);
     glAttachShader(m_program_id, m_fragment_shader);
+    program_cache_prepare(m_program_id);
     glLinkProgram(m_program_id);
+}
+
+bool ShaderProgram::is_ready() const
+{
+    // without the extension, asking for the link status would block anyway
+    if (!m_parallel_compile) return true;
+
+    GLint completed = GL_FALSE;
+    glGetProgramiv(m_program_id, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
 
+bool ShaderProgram::finish_load()
+{
     GLint link_success;
     glGetProgramiv(m_program_id, GL_LINK_STATUS, &link_success);
 
     if (link_success == GL_FALSE)
     {
         printf("Error linking shader program!\n");
+        print_shader_log(m_vertex_shader);
+        print_shader_log(m_fragment_shader);
+        return false;
     }
 
     m_model_matrix_uniform = glGetUniformLocation(m_program_id, "modelMatrix");
@@ -32,7 +104,7 @@ void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_sh
     m_tex_coord_attribute = glGetAttribLocation(m_program_id, "texCoord");
 
     set_colour(1.0f, 1.0f, 1.0f, 1.0f);
-
+    return true;
 }
 
 void ShaderProgram::cleanup()
@@ -43,6 +115,12 @@ void ShaderProgram::cleanup()
 }
 
 GLuint ShaderProgram::load_shader_from_file(const std::string& shaderFile, GLenum type)
+{
+    // Load the shader from the contents of the file
+    return load_shader_from_string(read_shader_file(shaderFile), type);
+}
+
+std::string ShaderProgram::read_shader_file(const std::string& shaderFile)
 {
     //Open a file stream with the file name
     std::ifstream infile(shaderFile);
@@ -55,8 +133,7 @@ GLuint ShaderProgram::load_shader_from_file(const std::string& shaderFile, GLenu
     std::stringstream buffer;
     buffer << infile.rdbuf();
 
-    // Load the shader from the contents of the file
-    return load_shader_from_string(buffer.str(), type);
+    return buffer.str();
 }
 
 GLuint ShaderProgram::load_shader_from_string(const std::string& shaderContents, GLenum type)
@@ -72,6 +149,14 @@ GLuint ShaderProgram::load_shader_from_string(const std::string& shaderContents,
     glShaderSource(shaderID, 1, &shader_string, &shader_string_length);
     glCompileShader(shaderID);
 
+    // return the shader id
+    return shaderID;
+}
+
+void ShaderProgram::print_shader_log(GLuint shaderID)
+{
+    if (shaderID == 0) return;
+
     // Check if the shader compiled properly
     GLint compile_success;
     glGetShaderiv(shaderID, GL_COMPILE_STATUS, &compile_success);
@@ -83,9 +168,6 @@ GLuint ShaderProgram::load_shader_from_string(const std::string& shaderContents,
         glGetShaderInfoLog(shaderID, sizeof(messages), 0, &messages[0]);
         std::cout << messages << std::endl;
     }
-
-    // return the shader id
-    return shaderID;
 }
 
 void ShaderProgram::set_colour(float red, float green, float blue, float alpha)
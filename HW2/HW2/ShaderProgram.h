@@ -14,10 +14,10 @@
 class ShaderProgram
 {
 private:
-    void cleanup();
-
     GLuint load_shader_from_string(const std::string& shader_contents, GLenum shader_type);
     GLuint load_shader_from_file(const std::string& shader_file, GLenum shader_type);
+    std::string read_shader_file(const std::string& shader_file);
+    void print_shader_log(GLuint shader_id);
 
     GLuint m_program_id;
 
@@ -32,9 +32,22 @@ private:
     GLuint m_vertex_shader;
     GLuint m_fragment_shader;
 
+    bool m_parallel_compile = false;
+
 public:
 
-    void load(const char* vertex_shader_file, const char* fragment_shader_file);
+    // with a binary_cache_path the linked program is cached there, see ProgramCache.h
+    void load(const char* vertex_shader_file, const char* fragment_shader_file, const char* binary_cache_path = NULL);
+
+    // Starts compiling and linking without waiting on the driver. With
+    // KHR_parallel_shader_compile the driver works on its own threads and
+    // is_ready() can be polled each frame; finish_load() then looks up the
+    // uniforms and returns false if the program didn't link.
+    void load_async(const std::string& vertex_source, const std::string& fragment_source);
+    bool is_ready() const;
+    bool finish_load();
+
+    void cleanup();
 
     void set_model_matrix(const glm::mat4& matrix);
     void set_projection_matrix(const glm::mat4& matrix);
@@ -0,0 +1,120 @@
+#include "ShaderWatcher.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+const int SHADER_WATCHER_POLL_MS = 100; // how often the thread checks for stop()
+
+static bool read_file(const std::string& filepath, std::string& contents)
+{
+    std::ifstream infile(filepath);
+    if (infile.fail()) return false;
+
+    std::stringstream buffer;
+    buffer << infile.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+static bool is_shader_file(const char* name)
+{
+    size_t length = strlen(name);
+    return length > 5 && strcmp(name + length - 5, ".glsl") == 0;
+}
+
+bool ShaderWatcher::start(const char* directory, const char* vertex_path, const char* fragment_path)
+{
+#ifdef __linux__
+    m_vertex_path = vertex_path;
+    m_fragment_path = fragment_path;
+
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0) return false;
+
+    // editors often save by writing a new file and renaming it over the old one
+    if (inotify_add_watch(m_inotify, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        close(m_inotify);
+        m_inotify = -1;
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&ShaderWatcher::run, this);
+    return true;
+#else
+    (void)directory;
+    (void)vertex_path;
+    (void)fragment_path;
+    printf("Shader hot reload is only supported on Linux\n");
+    return false;
+#endif
+}
+
+void ShaderWatcher::stop()
+{
+    if (!m_running) return;
+    m_running = false;
+    m_thread.join();
+
+#ifdef __linux__
+    close(m_inotify);
+    m_inotify = -1;
+#endif
+}
+
+void ShaderWatcher::run()
+{
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+
+    while (m_running)
+    {
+        struct pollfd descriptor = { m_inotify, POLLIN, 0 };
+        if (poll(&descriptor, 1, SHADER_WATCHER_POLL_MS) <= 0) continue;
+
+        bool shader_changed = false;
+        ssize_t length;
+        while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* next = buffer; next < buffer + length;)
+            {
+                const struct inotify_event* event = (const struct inotify_event*)next;
+                if (event->len > 0 && is_shader_file(event->name)) shader_changed = true;
+                next += sizeof(struct inotify_event) + event->len;
+            }
+        }
+        if (!shader_changed) continue;
+
+        std::string vertex_source, fragment_source;
+        if (!read_file(m_vertex_path, vertex_source) || !read_file(m_fragment_path, fragment_source))
+        {
+            printf("Unable to read changed shaders\n");
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_vertex_source.swap(vertex_source);
+        m_fragment_source.swap(fragment_source);
+        m_changed = true;
+    }
+#endif
+}
+
+bool ShaderWatcher::take_changed_sources(std::string& vertex_source, std::string& fragment_source)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_changed) return false;
+
+    vertex_source.swap(m_vertex_source);
+    fragment_source.swap(m_fragment_source);
+    m_changed = false;
+    return true;
+}
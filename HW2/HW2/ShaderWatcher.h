@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Watches a directory for saved *.glsl files (inotify, Linux only) on its own
+// thread. When one changes it reads a program's vertex and fragment sources
+// there too, so whoever owns the GL context only has to compile them.
+class ShaderWatcher
+{
+private:
+    std::string m_vertex_path,
+        m_fragment_path;
+
+    int m_inotify = -1;
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+
+    std::mutex m_mutex;
+    bool m_changed = false;
+    std::string m_vertex_source,
+        m_fragment_source;
+
+    void run();
+
+public:
+    // false if the directory can't be watched
+    bool start(const char* directory, const char* vertex_path, const char* fragment_path);
+    void stop();
+
+    // true once after a change, with both sources as they were read after it
+    bool take_changed_sources(std::string& vertex_source, std::string& fragment_source);
+};
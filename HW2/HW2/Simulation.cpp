@@ -0,0 +1,146 @@
+#include "Simulation.h"
+#include "glm/glm.hpp"
+#include "glm/gtx/intersect.hpp"
+#include <cmath>
+#include <utility>
+
+static std::pair<bool, int> wall_check(const glm::vec3& position, float offset)
+{
+    float wall = WALL_BORDER + offset;
+    if (position.y > wall) return std::make_pair(true, 1);
+    if (position.y < -wall) return std::make_pair(true, -1);
+    return std::make_pair(false, 0);
+}
+
+static void limit_to_border(glm::vec3& position, glm::vec3& movement)
+{
+    std::pair<bool, int> wall_check_outcome = wall_check(position, 0.0f);
+    if (wall_check_outcome.first)
+    {
+        position.y = WALL_BORDER * wall_check_outcome.second;
+        movement.y = 0;
+    }
+}
+
+// turns the tumbleweed's movement and remaining step along one axis to point
+// the way the normal does, away from the cowboy it hit
+static void bounce_away(GameState& state, glm::vec3& tumbleweed_step, const glm::vec2& normal)
+{
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (normal[axis] == 0.0f) continue;
+        tumbleweed_step[axis] = fabsf(tumbleweed_step[axis]) * normal[axis];
+        state.tumbleweed_movement[axis] = fabsf(state.tumbleweed_movement[axis]) * normal[axis];
+    }
+}
+
+// sweeps the tumbleweed along this tick's step so it can't tunnel through a cowboy
+// at high speed, and bounces it back at the point of contact
+static void cowboy_check(GameState& state, glm::vec3& tumbleweed_step,
+    const glm::vec3& obstacle_pos, bool is_left)
+{
+    glm::vec2 tumbleweed_half_size = glm::vec2(tumbleweed_scale.x, tumbleweed_scale.y * 2.5f) / 2.0f;
+    glm::vec2 obstacle_half_size = glm::vec2(cowboy_scale.x * 2.0f, cowboy_scale.y * 2.5f) / 2.0f;
+    glm::vec2 obstacle_center = glm::vec2(obstacle_pos.x + (is_left ? -COWBOY_OFFSET : COWBOY_OFFSET), obstacle_pos.y);
+
+    // already overlapping, e.g. a cowboy moved onto it: the sweep can't see that,
+    // so push it out the shortest way and bounce off that face
+    glm::vec2 offset = glm::vec2(state.tumbleweed_position) - obstacle_center;
+    glm::vec2 penetration = tumbleweed_half_size + obstacle_half_size - glm::abs(offset);
+    if (penetration.x > 0.0f && penetration.y > 0.0f)
+    {
+        glm::vec2 normal(0.0f);
+        if (penetration.x <= penetration.y)
+        {
+            // dead centre goes back towards the middle of the field
+            normal.x = offset.x != 0.0f ? glm::sign(offset.x) : (is_left ? 1.0f : -1.0f);
+            state.tumbleweed_position.x += normal.x * penetration.x;
+        }
+        else
+        {
+            normal.y = offset.y >= 0.0f ? 1.0f : -1.0f;
+            state.tumbleweed_position.y += normal.y * penetration.y;
+        }
+        bounce_away(state, tumbleweed_step, normal);
+        return;
+    }
+
+    float hit_time;
+    glm::vec2 hit_normal;
+    if (glm::intersectSweptAABB(glm::vec2(state.tumbleweed_position), tumbleweed_half_size, glm::vec2(tumbleweed_step),
+        obstacle_center, obstacle_half_size, hit_time, hit_normal))
+    {
+        // move up to the contact point, then spend the rest of the step going back,
+        // off the front of the cowboy or its top or bottom
+        state.tumbleweed_position += tumbleweed_step * hit_time;
+        tumbleweed_step *= 1.0f - hit_time;
+        bounce_away(state, tumbleweed_step, hit_normal);
+    }
+}
+
+static void wall_bounce(glm::vec3& tumbleweed_pos, glm::vec3& tumbleweed_move)
+{
+    if (wall_check(tumbleweed_pos, TUMBLEWEED_WALL - WALL_BORDER).first)
+    {
+        tumbleweed_move.y *= -1.0f;
+    }
+}
+
+static void check_for_game_end(GameState& state)
+{
+    if (state.tumbleweed_position.x > 11.0f) state.winner = 1;
+    if (state.tumbleweed_position.x < -11.0f) state.winner = 2;
+}
+
+void simulation_reset(GameState& state)
+{
+    state.left_cowboy_position = glm::vec3(-COWBOY_OFFSET, 0.0f, 0.0f);
+    state.left_cowboy_movement = glm::vec3(0.0f);
+    state.right_cowboy_position = glm::vec3(COWBOY_OFFSET, 0.0f, 0.0f);
+    state.right_cowboy_movement = glm::vec3(0.0f);
+    state.tumbleweed_position = glm::vec3(0.0f);
+    state.tumbleweed_movement = glm::vec3(1.0f, 0.5f, 0.0f);
+    state.winner = 0;
+    state.tick = 0;
+}
+
+void simulation_step(GameState& state, uint8_t input)
+{
+    state.tick++;
+    if (state.winner != 0) return;
+
+    // a cowboy keeps moving in the last direction pressed until it reaches the border
+    if (input & INPUT_LEFT_UP) state.left_cowboy_movement.y = 1.0f;
+    if (input & INPUT_LEFT_DOWN) state.left_cowboy_movement.y = -1.0f;
+    if (input & INPUT_RIGHT_UP) state.right_cowboy_movement.y = 1.0f;
+    if (input & INPUT_RIGHT_DOWN) state.right_cowboy_movement.y = -1.0f;
+
+    // multiple movement by speed and time for both
+    state.left_cowboy_position += state.left_cowboy_movement * COWBOY_MOVEMENT_SPEED * FIXED_TIMESTEP;
+    state.right_cowboy_position += state.right_cowboy_movement * COWBOY_MOVEMENT_SPEED * FIXED_TIMESTEP;
+    glm::vec3 tumbleweed_step = state.tumbleweed_movement * TUMBLEWEED_SPEED * FIXED_TIMESTEP;
+
+    // limit the cowboys' vertical movement to within the screen
+    limit_to_border(state.left_cowboy_position, state.left_cowboy_movement);
+    limit_to_border(state.right_cowboy_position, state.right_cowboy_movement);
+
+    // bounce off surfaces
+    cowboy_check(state, tumbleweed_step, state.left_cowboy_position, true);
+    cowboy_check(state, tumbleweed_step, state.right_cowboy_position, false);
+    state.tumbleweed_position += tumbleweed_step;
+    wall_bounce(state.tumbleweed_position, state.tumbleweed_movement);
+
+    check_for_game_end(state);
+}
+
+uint64_t simulation_hash(const GameState& state)
+{
+    const unsigned char* bytes = (const unsigned char*)&state;
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < sizeof(GameState); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "glm/vec3.hpp"
+
+// The game rules, separate from SDL and OpenGL so matches can be re-simulated
+// headlessly. The simulation only advances in FIXED_TIMESTEP ticks and only
+// reads its input from the tick's input bits, so the same inputs always give
+// the same state bit for bit on a given build.
+
+const float FIXED_TIMESTEP = 1.0f / 240.0f;
+
+// input bits for one tick
+const uint8_t INPUT_LEFT_UP = 1 << 0,
+INPUT_LEFT_DOWN = 1 << 1,
+INPUT_RIGHT_UP = 1 << 2,
+INPUT_RIGHT_DOWN = 1 << 3;
+
+// offset x position to get the cowboys in their starting points
+const float COWBOY_OFFSET = 4.3f;
+
+const float COWBOY_MOVEMENT_SPEED = 3.0f;
+const float TUMBLEWEED_SPEED = 4.0f;
+const float WALL_BORDER = 3.0f; // cowboys stop here
+const float TUMBLEWEED_WALL = 7.0f; // the tumbleweed bounces once it's past here
+
+// scale matrixes
+const glm::vec3 cowboy_scale = glm::vec3(1.0f, 1.0f, 0.0f),
+tumbleweed_scale = glm::vec3(0.5f, 0.5f, 0.0f);
+
+// Everything the simulation reads or writes. It is plain data with no padding,
+// so snapshots are a memcpy and the hash can run over the raw bytes.
+struct GameState
+{
+    glm::vec3 left_cowboy_position,
+    left_cowboy_movement,
+    right_cowboy_position,
+    right_cowboy_movement,
+    tumbleweed_position,
+    tumbleweed_movement;
+
+    int32_t winner; // 0 while playing, then 1 or 2
+    uint32_t tick; // ticks simulated since the reset
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must be copyable with memcpy");
+static_assert(sizeof(GameState) == 6 * sizeof(glm::vec3) + 2 * sizeof(uint32_t), "GameState must not contain padding");
+
+void simulation_reset(GameState& state);
+void simulation_step(GameState& state, uint8_t input);
+
+// FNV-1a over the state, to detect desyncs and compare runs
+uint64_t simulation_hash(const GameState& state);
+
+// Fixed ring of the last Size states, keyed by their tick. Saving and loading
+// copy the state in place, nothing is allocated after construction.
+template <uint32_t Size>
+class SnapshotRing
+{
+private:
+    GameState m_states[Size];
+    bool m_valid[Size] = {};
+
+public:
+    void save(const GameState& state)
+    {
+        uint32_t slot = state.tick % Size;
+        memcpy(&m_states[slot], &state, sizeof(GameState));
+        m_valid[slot] = true;
+    }
+
+    // returns false if the tick was never saved or has been overwritten since
+    bool load(uint32_t tick, GameState& state) const
+    {
+        uint32_t slot = tick % Size;
+        if (!m_valid[slot] || m_states[slot].tick != tick) return false;
+
+        memcpy(&state, &m_states[slot], sizeof(GameState));
+        return true;
+    }
+
+    void clear()
+    {
+        for (uint32_t slot = 0; slot < Size; slot++) m_valid[slot] = false;
+    }
+};
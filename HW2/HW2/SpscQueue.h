@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer single-consumer queue. One thread may push and one
+// other thread may pop without locks; Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+private:
+    T m_items[Capacity];
+
+    // each index is only written by one side, keep them on separate cache lines
+    alignas(64) std::atomic<size_t> m_head{ 0 }; // next slot to pop, owned by the consumer
+    alignas(64) std::atomic<size_t> m_tail{ 0 }; // next slot to push, owned by the producer
+
+public:
+    // returns false without blocking when the queue is full
+    bool try_push(const T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) return false;
+
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // returns false without blocking when the queue is empty
+    bool try_pop(T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // the oldest item without removing it, or NULL when empty; consumer only
+    const T* peek() const
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return NULL;
+        return &m_items[head & (Capacity - 1)];
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+};
@@ -0,0 +1,130 @@
+#define GL_SILENCE_DEPRECATION
+
+#include "StreamBuffer.h"
+#include "Profiler.h"
+#include <cstdio>
+
+const size_t STREAM_BUFFER_ALIGNMENT = 16;
+const GLuint64 STREAM_BUFFER_WAIT_NS = 1000000;
+
+void StreamBuffer::initialise(size_t frame_size)
+{
+    m_frame_size = (frame_size + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1);
+    m_used = 0;
+    m_frame = 0;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+    // macOS stops at OpenGL 4.1, buffer storage is 4.4
+#ifndef __APPLE__
+    if (gl_version() >= 44 || gl_extension_supported("GL_ARB_buffer_storage"))
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr size = (GLsizeiptr)(m_frame_size * STREAM_BUFFER_FRAMES);
+        glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+        m_mapped = (uint8_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        m_persistent = m_mapped != NULL;
+
+        // storage is immutable once set, so falling back needs a new buffer
+        if (!m_persistent)
+        {
+            glDeleteBuffers(1, &m_buffer);
+            glGenBuffers(1, &m_buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        }
+    }
+#endif
+
+    if (!m_persistent)
+    {
+        printf("Persistent mapping not supported, streaming by orphaning\n");
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m_frame_size, NULL, GL_STREAM_DRAW);
+        m_staging.resize(m_frame_size);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamBuffer::shutdown()
+{
+    if (m_buffer == 0) return;
+
+    for (GLsync& fence : m_fences)
+    {
+        if (fence != NULL) glDeleteSync(fence);
+        fence = NULL;
+    }
+
+    if (m_persistent)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        m_mapped = NULL;
+    }
+
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+}
+
+void StreamBuffer::begin_frame()
+{
+    m_used = 0;
+
+    GLsync& fence = m_fences[m_frame];
+    if (fence == NULL) return;
+
+    // only blocks when the GPU is STREAM_BUFFER_FRAMES frames behind
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        PROFILE_ZONE("stream_buffer_wait");
+        do
+        {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, STREAM_BUFFER_WAIT_NS);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    glDeleteSync(fence);
+    fence = NULL;
+}
+
+void* StreamBuffer::allocate(size_t size, size_t& offset)
+{
+    size = (size + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1);
+    if (m_used + size > m_frame_size) return NULL;
+
+    void* data;
+    if (m_persistent)
+    {
+        offset = m_frame * m_frame_size + m_used;
+        data = m_mapped + offset;
+    }
+    else
+    {
+        offset = m_used;
+        data = m_staging.data() + offset;
+    }
+
+    m_used += size;
+    return data;
+}
+
+void StreamBuffer::flush()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+
+    // coherent mapping, writes are already visible
+    if (m_persistent) return;
+
+    // new storage for every frame so the upload never waits on the last frame's draws
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m_frame_size, NULL, GL_STREAM_DRAW);
+    if (m_used > 0) glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)m_used, m_staging.data());
+}
+
+void StreamBuffer::end_frame()
+{
+    if (m_persistent) m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_frame = (m_frame + 1) % STREAM_BUFFER_FRAMES;
+}
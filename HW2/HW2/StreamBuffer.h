@@ -0,0 +1,56 @@
+#pragma once
+
+#include "GlUtil.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// frames of vertex data the GPU may still be reading while the CPU writes the next
+const int STREAM_BUFFER_FRAMES = 3;
+
+// Streams vertex data that changes every frame. With ARB_buffer_storage the
+// buffer is mapped once, persistently, and split into STREAM_BUFFER_FRAMES
+// regions; a fence per region says when the GPU is done with it, so writing
+// only waits if the CPU gets a whole ring ahead. Without it, flush() orphans
+// the buffer with glBufferData and the driver hands back fresh storage.
+// Nothing is reallocated after initialise().
+//
+//     stream.begin_frame();
+//     void* vertices = stream.allocate(size, offset);
+//     ...write vertices...
+//     stream.flush();
+//     ...draw with attribute pointers at offset...
+//     stream.end_frame();
+class StreamBuffer
+{
+private:
+    GLuint m_buffer = 0;
+    bool m_persistent = false;
+    size_t m_frame_size = 0;
+    size_t m_used = 0;
+    int m_frame = 0;
+
+    uint8_t* m_mapped = NULL; // every region, when persistent
+    std::vector<uint8_t> m_staging; // this frame's data until flush(), otherwise
+    GLsync m_fences[STREAM_BUFFER_FRAMES] = {};
+
+public:
+    // needs a current GL context; frame_size is the most one frame can allocate
+    void initialise(size_t frame_size);
+    void shutdown();
+
+    // waits until the GPU has finished with this frame's region
+    void begin_frame();
+
+    // size bytes to write this frame, or NULL if the frame is full; offset is
+    // where they start in the buffer, for glVertexAttribPointer
+    void* allocate(size_t size, size_t& offset);
+
+    // makes this frame's data visible to the GPU and leaves the buffer bound to GL_ARRAY_BUFFER
+    void flush();
+
+    // call after the last draw reading this frame's data
+    void end_frame();
+
+    bool is_persistent() const { return m_persistent; }
+};
@@ -0,0 +1,150 @@
+#include "TextureBaker.h"
+#include "Mipmap.h"
+#include "TextureCompression.h"
+#include "TextureFile.h"
+#include "stb_image.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+// block rows per job, small enough to balance threads on tiny mip levels
+const int BAKE_BLOCK_ROWS_PER_JOB = 4;
+
+struct BakeImage
+{
+    const char* path;
+    TextureCompression compression;
+    TextureData source; // RGBA8 mip chain
+    TextureData baked;
+};
+
+struct BakeJob
+{
+    BakeImage* image;
+    size_t level;
+    int first_block_row, end_block_row;
+};
+
+static GLenum gl_format_for(TextureCompression compression)
+{
+    switch (compression)
+    {
+        case COMPRESSION_BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case COMPRESSION_BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case COMPRESSION_ETC2_RGB8: return GL_COMPRESSED_RGB8_ETC2;
+        default: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+    }
+}
+
+static const char* name_for(TextureCompression compression)
+{
+    switch (compression)
+    {
+        case COMPRESSION_BC1: return "BC1";
+        case COMPRESSION_BC3: return "BC3";
+        case COMPRESSION_ETC2_RGB8: return "ETC2 RGB8";
+        default: return "ETC2 RGBA8 EAC";
+    }
+}
+
+bool bake_textures(const std::vector<const char*>& image_paths, TextureBakeTarget target, int thread_count)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool success = true;
+
+    std::vector<BakeImage> images;
+    images.reserve(image_paths.size());
+    for (const char* path : image_paths)
+    {
+        // the loader only uses the bake while the image's bytes still hash the same
+        std::vector<uint8_t> image_file;
+        int width, height, number_of_components;
+        unsigned char* pixels = read_file(path, image_file) ? stbi_load_from_memory(image_file.data(), (int)image_file.size(),
+            &width, &height, &number_of_components, STBI_rgb_alpha) : NULL;
+        if (pixels == NULL)
+        {
+            printf("%s: unable to load image\n", path);
+            success = false;
+            continue;
+        }
+
+        images.push_back(BakeImage());
+        BakeImage& image = images.back();
+        image.path = path;
+        image.source.add_level(width, height, (size_t)width * height * 4);
+        memcpy(image.source.data.data(), pixels, image.source.data.size());
+        stbi_image_free(pixels);
+
+        bool opaque = true;
+        for (size_t i = 3; i < image.source.data.size() && opaque; i += 4) opaque = image.source.data[i] == 255;
+        if (target == BAKE_BC) image.compression = opaque ? COMPRESSION_BC1 : COMPRESSION_BC3;
+        else image.compression = opaque ? COMPRESSION_ETC2_RGB8 : COMPRESSION_ETC2_EAC;
+
+        build_mip_chain(image.source);
+
+        image.baked.internal_format = gl_format_for(image.compression);
+        image.baked.compressed = true;
+        image.baked.source_hash = texture_source_hash(image_file);
+        for (const TextureLevel& level : image.source.levels)
+        {
+            image.baked.add_level(level.width, level.height, compressed_level_size(image.compression, level.width, level.height));
+        }
+    }
+
+    std::vector<BakeJob> jobs;
+    for (BakeImage& image : images)
+    {
+        for (size_t level = 0; level < image.source.levels.size(); level++)
+        {
+            int block_rows = (image.source.levels[level].height + 3) / 4;
+            for (int row = 0; row < block_rows; row += BAKE_BLOCK_ROWS_PER_JOB)
+            {
+                BakeJob job = { &image, level, row, row + BAKE_BLOCK_ROWS_PER_JOB < block_rows ? row + BAKE_BLOCK_ROWS_PER_JOB : block_rows };
+                jobs.push_back(job);
+            }
+        }
+    }
+
+    // every job writes its own blocks, the only shared state is the next job
+    std::atomic<size_t> next_job{ 0 };
+    auto work = [&]()
+    {
+        size_t index;
+        while ((index = next_job.fetch_add(1)) < jobs.size())
+        {
+            const BakeJob& job = jobs[index];
+            const TextureLevel& source = job.image->source.levels[job.level];
+            compress_block_rows(job.image->compression, &job.image->source.data[source.offset], source.width, source.height,
+                job.first_block_row, job.end_block_row, &job.image->baked.data[job.image->baked.levels[job.level].offset]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < thread_count; i++) threads.emplace_back(work);
+    work();
+    for (std::thread& thread : threads) thread.join();
+
+    size_t source_bytes = 0, baked_bytes = 0;
+    for (const BakeImage& image : images)
+    {
+        std::string baked_path = baked_texture_path(image.path);
+        if (!ktx_save(baked_path.c_str(), image.baked))
+        {
+            printf("%s: unable to write %s\n", image.path, baked_path.c_str());
+            success = false;
+            continue;
+        }
+
+        source_bytes += image.source.data.size();
+        baked_bytes += image.baked.data.size();
+        printf("%s -> %s: %s, %d levels, %zu KB from %zu KB\n", image.path, baked_path.c_str(), name_for(image.compression),
+            (int)image.baked.levels.size(), image.baked.data.size() / 1024, image.source.data.size() / 1024);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Baked %d images on %d threads in %.3fs, %zu KB from %zu KB with mips\n",
+        (int)images.size(), thread_count, seconds, baked_bytes / 1024, source_bytes / 1024);
+    return success;
+}
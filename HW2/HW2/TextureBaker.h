@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+enum TextureBakeTarget
+{
+    BAKE_BC, // BC1 for opaque images, BC3 otherwise; desktop GPUs
+    BAKE_ETC2 // ETC2 RGB8 or RGBA8 EAC; GLES-class GPUs
+};
+
+// Compresses images to .ktx files next to them (see baked_texture_path) with
+// full mip chains, which load_texture then uploads instead of the image. The
+// blocks of every level of every image are shared out between thread_count
+// threads. Returns false if any image failed.
+bool bake_textures(const std::vector<const char*>& image_paths, TextureBakeTarget target, int thread_count);
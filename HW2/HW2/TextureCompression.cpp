@@ -0,0 +1,552 @@
+#include "TextureCompression.h"
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+static int clamp_byte(int value)
+{
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static int colour_distance(const int a[3], const int b[3])
+{
+    int red = a[0] - b[0], green = a[1] - b[1], blue = a[2] - b[2];
+    return red * red + green * green + blue * blue;
+}
+
+size_t compressed_block_size(TextureCompression compression)
+{
+    return compression == COMPRESSION_BC1 || compression == COMPRESSION_ETC2_RGB8 ? 8 : 16;
+}
+
+size_t compressed_level_size(TextureCompression compression, int width, int height)
+{
+    size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+    return blocks * compressed_block_size(compression);
+}
+
+void compress_block_rows(TextureCompression compression, const uint8_t* rgba, int width, int height,
+    int first_block_row, int end_block_row, uint8_t* out)
+{
+    int blocks_wide = (width + 3) / 4;
+    size_t block_size = compressed_block_size(compression);
+
+    uint8_t block[64];
+    for (int block_y = first_block_row; block_y < end_block_row; block_y++)
+    {
+        for (int block_x = 0; block_x < blocks_wide; block_x++)
+        {
+            for (int y = 0; y < 4; y++)
+            {
+                int source_y = block_y * 4 + y < height ? block_y * 4 + y : height - 1;
+                for (int x = 0; x < 4; x++)
+                {
+                    int source_x = block_x * 4 + x < width ? block_x * 4 + x : width - 1;
+                    memcpy(&block[(y * 4 + x) * 4], &rgba[((size_t)source_y * width + source_x) * 4], 4);
+                }
+            }
+
+            uint8_t* destination = out + ((size_t)block_y * blocks_wide + block_x) * block_size;
+            switch (compression)
+            {
+                case COMPRESSION_BC1: compress_bc1_block(block, destination); break;
+                case COMPRESSION_BC3: compress_bc3_block(block, destination); break;
+                case COMPRESSION_ETC2_RGB8: compress_etc2_rgb8_block(block, destination); break;
+                case COMPRESSION_ETC2_EAC: compress_etc2_eac_block(block, destination); break;
+            }
+        }
+    }
+}
+
+// ---- BC1 / BC3 ----
+
+static uint16_t pack_565(const float colour[3])
+{
+    int red = (int)(colour[0] * 31.0f / 255.0f + 0.5f),
+        green = (int)(colour[1] * 63.0f / 255.0f + 0.5f),
+        blue = (int)(colour[2] * 31.0f / 255.0f + 0.5f);
+    red = red < 0 ? 0 : (red > 31 ? 31 : red);
+    green = green < 0 ? 0 : (green > 63 ? 63 : green);
+    blue = blue < 0 ? 0 : (blue > 31 ? 31 : blue);
+    return (uint16_t)((red << 11) | (green << 5) | blue);
+}
+
+static void unpack_565(uint16_t packed, int colour[3])
+{
+    int red = (packed >> 11) & 31, green = (packed >> 5) & 63, blue = packed & 31;
+    colour[0] = (red << 3) | (red >> 2);
+    colour[1] = (green << 2) | (green >> 4);
+    colour[2] = (blue << 3) | (blue >> 2);
+}
+
+// Endpoints are the extreme pixels along the colours' principal axis, pulled
+// in slightly since the ends of the range are rarely hit exactly. Pixels with
+// no alpha are left out of the fit, their colour never shows.
+static void compress_colour_block(const uint8_t block[64], bool skip_transparent, uint8_t out[8])
+{
+    int used[16], used_count = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        if (!skip_transparent || block[i * 4 + 3] != 0) used[used_count++] = i;
+    }
+    if (used_count == 0)
+    {
+        for (int i = 0; i < 16; i++) used[i] = i;
+        used_count = 16;
+    }
+
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int n = 0; n < used_count; n++)
+    {
+        for (int c = 0; c < 3; c++) mean[c] += block[used[n] * 4 + c];
+    }
+    for (int c = 0; c < 3; c++) mean[c] /= used_count;
+
+    float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int n = 0; n < used_count; n++)
+    {
+        float red = block[used[n] * 4] - mean[0],
+            green = block[used[n] * 4 + 1] - mean[1],
+            blue = block[used[n] * 4 + 2] - mean[2];
+        covariance[0] += red * red;
+        covariance[1] += red * green;
+        covariance[2] += red * blue;
+        covariance[3] += green * green;
+        covariance[4] += green * blue;
+        covariance[5] += blue * blue;
+    }
+
+    // a few power iterations find the principal axis well enough
+    float axis[3] = { 0.577f, 0.577f, 0.577f };
+    for (int iteration = 0; iteration < 4; iteration++)
+    {
+        float next[3] = {
+            covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2],
+            covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2],
+            covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2]
+        };
+        float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (length < 1e-6f) break;
+        for (int c = 0; c < 3; c++) axis[c] = next[c] / length;
+    }
+
+    float min_projection = 1e9f, max_projection = -1e9f;
+    for (int n = 0; n < used_count; n++)
+    {
+        float projection = 0.0f;
+        for (int c = 0; c < 3; c++) projection += (block[used[n] * 4 + c] - mean[c]) * axis[c];
+        if (projection < min_projection) min_projection = projection;
+        if (projection > max_projection) max_projection = projection;
+    }
+
+    float inset = (max_projection - min_projection) / 16.0f;
+    float low[3], high[3];
+    for (int c = 0; c < 3; c++)
+    {
+        low[c] = mean[c] + (min_projection + inset) * axis[c];
+        high[c] = mean[c] + (max_projection - inset) * axis[c];
+    }
+
+    uint16_t colour0 = pack_565(high), colour1 = pack_565(low);
+    if (colour0 < colour1)
+    {
+        uint16_t swap = colour0;
+        colour0 = colour1;
+        colour1 = swap;
+    }
+
+    // colour0 > colour1 selects the four colour mode; equal endpoints need no indices
+    uint32_t indices = 0;
+    if (colour0 != colour1)
+    {
+        int palette[4][3];
+        unpack_565(colour0, palette[0]);
+        unpack_565(colour1, palette[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            int pixel[3] = { block[i * 4], block[i * 4 + 1], block[i * 4 + 2] };
+            int best = 0, best_distance = INT_MAX;
+            for (int p = 0; p < 4; p++)
+            {
+                int distance = colour_distance(pixel, palette[p]);
+                if (distance < best_distance)
+                {
+                    best_distance = distance;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t)best << (i * 2);
+        }
+    }
+
+    out[0] = (uint8_t)colour0;
+    out[1] = (uint8_t)(colour0 >> 8);
+    out[2] = (uint8_t)colour1;
+    out[3] = (uint8_t)(colour1 >> 8);
+    for (int i = 0; i < 4; i++) out[4 + i] = (uint8_t)(indices >> (i * 8));
+}
+
+void compress_bc1_block(const uint8_t block[64], uint8_t out[8])
+{
+    compress_colour_block(block, false, out);
+}
+
+// returns the squared error; fills the 3 bit indices
+static int fit_bc3_alpha(const uint8_t block[64], const int palette[8], uint8_t indices[16])
+{
+    int error = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int alpha = block[i * 4 + 3];
+        int best = 0, best_distance = INT_MAX;
+        for (int p = 0; p < 8; p++)
+        {
+            int distance = (alpha - palette[p]) * (alpha - palette[p]);
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                best = p;
+            }
+        }
+        indices[i] = (uint8_t)best;
+        error += best_distance;
+    }
+    return error;
+}
+
+// Tries both alpha modes: eight steps between the block's extremes, or six
+// steps between the extremes that aren't 0 or 255 plus exact 0 and 255, which
+// suits sprites with hard edges and a few soft pixels.
+static void compress_bc3_alpha_block(const uint8_t block[64], uint8_t out[8])
+{
+    int min_alpha = 255, max_alpha = 0, min_inner = 255, max_inner = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int alpha = block[i * 4 + 3];
+        if (alpha < min_alpha) min_alpha = alpha;
+        if (alpha > max_alpha) max_alpha = alpha;
+        if (alpha != 0 && alpha != 255)
+        {
+            if (alpha < min_inner) min_inner = alpha;
+            if (alpha > max_inner) max_inner = alpha;
+        }
+    }
+
+    int alpha0 = max_alpha, alpha1 = min_alpha;
+    int palette[8] = { alpha0, alpha1 };
+    for (int p = 1; p < 7; p++) palette[p + 1] = ((7 - p) * alpha0 + p * alpha1) / 7;
+    uint8_t indices[16];
+    int error = fit_bc3_alpha(block, palette, indices);
+
+    if (error > 0 && min_inner <= max_inner)
+    {
+        int inner0 = min_inner, inner1 = max_inner == min_inner ? min_inner + 1 : max_inner;
+        int six_palette[8] = { inner0, inner1 };
+        for (int p = 1; p < 5; p++) six_palette[p + 1] = ((5 - p) * inner0 + p * inner1) / 5;
+        six_palette[6] = 0;
+        six_palette[7] = 255;
+
+        uint8_t six_indices[16];
+        if (fit_bc3_alpha(block, six_palette, six_indices) < error)
+        {
+            alpha0 = inner0;
+            alpha1 = inner1;
+            memcpy(indices, six_indices, sizeof(indices));
+        }
+    }
+
+    // eight step mode needs alpha0 > alpha1; with equal endpoints every index 0 is exact
+    if (alpha0 == alpha1) memset(indices, 0, sizeof(indices));
+
+    out[0] = (uint8_t)alpha0;
+    out[1] = (uint8_t)alpha1;
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint64_t)indices[i] << (i * 3);
+    for (int i = 0; i < 6; i++) out[2 + i] = (uint8_t)(bits >> (i * 8));
+}
+
+void compress_bc3_block(const uint8_t block[64], uint8_t out[16])
+{
+    compress_bc3_alpha_block(block, out);
+    compress_colour_block(block, true, out + 8);
+}
+
+// ---- ETC2 ----
+
+const int ETC_MODIFIERS[8][4] = {
+    { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 },
+    { 18, 60, -18, -60 }, { 24, 80, -24, -80 }, { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+};
+
+const int EAC_MODIFIERS[16][8] = {
+    { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+// ETC numbers pixels down each column first
+static int etc_pixel_index(int x, int y)
+{
+    return x * 4 + y;
+}
+
+static bool etc_in_subblock(int x, int y, bool flip, int subblock)
+{
+    int position = flip ? y : x;
+    return subblock == 0 ? position < 2 : position >= 2;
+}
+
+// picks the modifier table for one half of the block around base; returns the squared error
+static int fit_etc_subblock(const uint8_t block[64], bool skip_transparent, bool flip, int subblock, const int base[3],
+    int& table, uint32_t& indices)
+{
+    int best_error = INT_MAX;
+    for (int t = 0; t < 8; t++)
+    {
+        int error = 0;
+        uint32_t table_indices = 0;
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                if (!etc_in_subblock(x, y, flip, subblock)) continue;
+
+                const uint8_t* pixel = &block[(y * 4 + x) * 4];
+                int pixel_colour[3] = { pixel[0], pixel[1], pixel[2] };
+                int best_modifier = 0, best_distance = INT_MAX;
+                for (int m = 0; m < 4; m++)
+                {
+                    int candidate[3];
+                    for (int c = 0; c < 3; c++) candidate[c] = clamp_byte(base[c] + ETC_MODIFIERS[t][m]);
+                    int distance = colour_distance(pixel_colour, candidate);
+                    if (distance < best_distance)
+                    {
+                        best_distance = distance;
+                        best_modifier = m;
+                    }
+                }
+
+                // index bits: msb of every pixel in the top half, lsb in the bottom half
+                int bit = etc_pixel_index(x, y);
+                table_indices |= (uint32_t)(best_modifier >> 1) << (bit + 16);
+                table_indices |= (uint32_t)(best_modifier & 1) << bit;
+                if (!skip_transparent || pixel[3] != 0) error += best_distance;
+            }
+        }
+
+        if (error < best_error)
+        {
+            best_error = error;
+            table = t;
+            indices = table_indices;
+        }
+    }
+    return best_error;
+}
+
+static void write_big_endian(uint64_t bits, uint8_t out[8])
+{
+    for (int i = 0; i < 8; i++) out[i] = (uint8_t)(bits >> (56 - i * 8));
+}
+
+// Tries both block splits with differential (555 + 333 delta) and individual
+// (444 + 444) base colours. Only the ETC1 modes are used; they decode the
+// same under ETC2 as long as the differential colours stay in range. Like BC3,
+// pixels with no alpha can be left out of the fit.
+static void compress_etc_colour_block(const uint8_t block[64], bool skip_transparent, uint8_t out[8])
+{
+    uint64_t best_bits = 0;
+    int best_error = INT_MAX;
+
+    for (int flip = 0; flip < 2; flip++)
+    {
+        // a half with nothing visible just averages all its pixels
+        float average[2][3], all_average[2][3];
+        int visible_count[2] = { 0, 0 };
+        for (int s = 0; s < 2; s++)
+        {
+            for (int c = 0; c < 3; c++) average[s][c] = all_average[s][c] = 0.0f;
+        }
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                const uint8_t* pixel = &block[(y * 4 + x) * 4];
+                int subblock = etc_in_subblock(x, y, flip != 0, 0) ? 0 : 1;
+                bool visible = !skip_transparent || pixel[3] != 0;
+                for (int c = 0; c < 3; c++)
+                {
+                    all_average[subblock][c] += pixel[c] / 8.0f;
+                    if (visible) average[subblock][c] += pixel[c];
+                }
+                if (visible) visible_count[subblock]++;
+            }
+        }
+        for (int s = 0; s < 2; s++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                average[s][c] = visible_count[s] > 0 ? average[s][c] / visible_count[s] : all_average[s][c];
+            }
+        }
+
+        for (int differential = 0; differential < 2; differential++)
+        {
+            int quantised[2][3], base[2][3];
+            bool representable = true;
+            for (int s = 0; s < 2; s++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    if (differential)
+                    {
+                        quantised[s][c] = (int)(average[s][c] * 31.0f / 255.0f + 0.5f);
+                        base[s][c] = (quantised[s][c] << 3) | (quantised[s][c] >> 2);
+                    }
+                    else
+                    {
+                        quantised[s][c] = (int)(average[s][c] * 15.0f / 255.0f + 0.5f);
+                        base[s][c] = (quantised[s][c] << 4) | quantised[s][c];
+                    }
+                }
+            }
+            if (differential)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    int delta = quantised[1][c] - quantised[0][c];
+                    if (delta < -4 || delta > 3) representable = false;
+                }
+            }
+            if (!representable) continue;
+
+            int table[2];
+            uint32_t indices[2];
+            int error = fit_etc_subblock(block, skip_transparent, flip != 0, 0, base[0], table[0], indices[0]) +
+                fit_etc_subblock(block, skip_transparent, flip != 0, 1, base[1], table[1], indices[1]);
+            if (error >= best_error) continue;
+
+            uint64_t bits = 0;
+            for (int c = 0; c < 3; c++)
+            {
+                int shift = 59 - c * 8;
+                if (differential)
+                {
+                    bits |= (uint64_t)quantised[0][c] << shift;
+                    bits |= (uint64_t)((quantised[1][c] - quantised[0][c]) & 7) << (shift - 3);
+                }
+                else
+                {
+                    bits |= (uint64_t)quantised[0][c] << (shift + 1);
+                    bits |= (uint64_t)quantised[1][c] << (shift - 3);
+                }
+            }
+            bits |= (uint64_t)table[0] << 37;
+            bits |= (uint64_t)table[1] << 34;
+            bits |= (uint64_t)differential << 33;
+            bits |= (uint64_t)flip << 32;
+            bits |= indices[0] | indices[1];
+
+            best_error = error;
+            best_bits = bits;
+        }
+    }
+
+    write_big_endian(best_bits, out);
+}
+
+void compress_etc2_rgb8_block(const uint8_t block[64], uint8_t out[8])
+{
+    compress_etc_colour_block(block, false, out);
+}
+
+// Uniform alpha, the bulk of most sprites, is stored exactly with the table
+// that has a zero step. Otherwise every table and multiplier is tried with the
+// base centred on the block's alpha range.
+static void compress_eac_alpha_block(const uint8_t block[64], uint8_t out[8])
+{
+    int min_alpha = 255, max_alpha = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int alpha = block[i * 4 + 3];
+        if (alpha < min_alpha) min_alpha = alpha;
+        if (alpha > max_alpha) max_alpha = alpha;
+    }
+
+    int best_base = min_alpha, best_multiplier = 1, best_table = 13;
+    uint64_t best_indices = 0;
+    if (min_alpha == max_alpha)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++) best_indices |= (uint64_t)4 << (45 - etc_pixel_index(x, y) * 3);
+        }
+    }
+    else
+    {
+        int best_error = INT_MAX;
+        for (int t = 0; t < 16 && best_error > 0; t++)
+        {
+            int table_min = EAC_MODIFIERS[t][3], table_max = EAC_MODIFIERS[t][7];
+            for (int multiplier = 1; multiplier < 16; multiplier++)
+            {
+                int centre = (int)std::lround((min_alpha + max_alpha) / 2.0 - (table_min + table_max) * multiplier / 2.0);
+                for (int offset = -1; offset <= 1; offset++)
+                {
+                    int base = clamp_byte(centre + offset);
+                    int error = 0;
+                    uint64_t indices = 0;
+                    for (int y = 0; y < 4 && error < best_error; y++)
+                    {
+                        for (int x = 0; x < 4; x++)
+                        {
+                            int alpha = block[(y * 4 + x) * 4 + 3];
+                            int best_step = 0, best_distance = INT_MAX;
+                            for (int step = 0; step < 8; step++)
+                            {
+                                int value = clamp_byte(base + EAC_MODIFIERS[t][step] * multiplier);
+                                int distance = (alpha - value) * (alpha - value);
+                                if (distance < best_distance)
+                                {
+                                    best_distance = distance;
+                                    best_step = step;
+                                }
+                            }
+                            indices |= (uint64_t)best_step << (45 - etc_pixel_index(x, y) * 3);
+                            error += best_distance;
+                        }
+                    }
+
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        best_base = base;
+                        best_multiplier = multiplier;
+                        best_table = t;
+                        best_indices = indices;
+                    }
+                }
+            }
+        }
+    }
+
+    uint64_t bits = (uint64_t)best_base << 56 | (uint64_t)best_multiplier << 52 | (uint64_t)best_table << 48 | best_indices;
+    write_big_endian(bits, out);
+}
+
+void compress_etc2_eac_block(const uint8_t block[64], uint8_t out[16])
+{
+    compress_eac_alpha_block(block, out);
+    compress_etc_colour_block(block, true, out + 8);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Block compressors for baking textures offline. Every format works on 4x4
+// pixel blocks; blocks hanging over the image edge repeat the edge pixels.
+//
+//   BC1        8 bytes a block, RGB, for opaque images (8:1 against RGBA8)
+//   BC3       16 bytes a block, BC1 colour plus an interpolated alpha block (4:1)
+//   ETC2 RGB8  8 bytes a block, for GLES-class drivers (ETC1 modes only)
+//   ETC2 EAC  16 bytes a block, ETC2 RGB8 plus an EAC alpha block
+enum TextureCompression
+{
+    COMPRESSION_BC1,
+    COMPRESSION_BC3,
+    COMPRESSION_ETC2_RGB8,
+    COMPRESSION_ETC2_EAC
+};
+
+size_t compressed_block_size(TextureCompression compression);
+size_t compressed_level_size(TextureCompression compression, int width, int height);
+
+// blocks [first_block_row, end_block_row) of an RGBA8 image into out, which
+// holds the whole level; rows are independent so threads can split them
+void compress_block_rows(TextureCompression compression, const uint8_t* rgba, int width, int height,
+    int first_block_row, int end_block_row, uint8_t* out);
+
+void compress_bc1_block(const uint8_t block[64], uint8_t out[8]);
+void compress_bc3_block(const uint8_t block[64], uint8_t out[16]);
+void compress_etc2_rgb8_block(const uint8_t block[64], uint8_t out[8]);
+void compress_etc2_eac_block(const uint8_t block[64], uint8_t out[16]);
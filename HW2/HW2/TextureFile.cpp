@@ -0,0 +1,168 @@
+#include "TextureFile.h"
+#include <cstdio>
+#include <cstring>
+
+const uint8_t KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+const uint32_t KTX_ENDIANNESS = 0x04030201;
+const char KTX_SOURCE_HASH_KEY[] = "HW2SourceHash"; // value is the 8 byte hash
+
+struct KtxHeader
+{
+    uint8_t identifier[12];
+    uint32_t endianness;
+    uint32_t gl_type; // 0 when compressed
+    uint32_t gl_type_size;
+    uint32_t gl_format; // 0 when compressed
+    uint32_t gl_internal_format;
+    uint32_t gl_base_internal_format;
+    uint32_t pixel_width;
+    uint32_t pixel_height;
+    uint32_t pixel_depth;
+    uint32_t number_of_array_elements;
+    uint32_t number_of_faces;
+    uint32_t number_of_mipmap_levels;
+    uint32_t bytes_of_key_value_data;
+};
+
+std::string baked_texture_path(const char* image_path)
+{
+    std::string path = image_path;
+    size_t extension = path.find_last_of('.');
+    size_t separator = path.find_last_of("/\\");
+    if (extension != std::string::npos && (separator == std::string::npos || extension > separator)) path.erase(extension);
+    return path + ".ktx";
+}
+
+bool read_file(const char* filepath, std::vector<uint8_t>& bytes)
+{
+    FILE* file = fopen(filepath, "rb");
+    if (file == NULL) return false;
+
+    bool valid = fseek(file, 0, SEEK_END) == 0;
+    long size = valid ? ftell(file) : -1;
+    valid = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+    if (valid)
+    {
+        bytes.resize((size_t)size);
+        valid = fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    }
+
+    fclose(file);
+    return valid;
+}
+
+uint64_t texture_source_hash(const std::vector<uint8_t>& image_file)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (uint8_t byte : image_file)
+    {
+        hash ^= byte;
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// one key/value pair: its size, the key with its terminator, the value, padded to 4 bytes
+static uint32_t source_hash_entry_size()
+{
+    return (uint32_t)(sizeof(KTX_SOURCE_HASH_KEY) + sizeof(uint64_t));
+}
+
+static uint32_t padded_to_4(uint32_t size)
+{
+    return (size + 3) & ~3u;
+}
+
+bool ktx_save(const char* filepath, const TextureData& texture)
+{
+    if (!texture.compressed || texture.levels.empty()) return false;
+
+    KtxHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER));
+    header.endianness = KTX_ENDIANNESS;
+    header.gl_type_size = 1;
+    header.gl_internal_format = texture.internal_format;
+    header.gl_base_internal_format = GL_RGBA;
+    header.pixel_width = texture.levels[0].width;
+    header.pixel_height = texture.levels[0].height;
+    header.number_of_faces = 1;
+    header.number_of_mipmap_levels = (uint32_t)texture.levels.size();
+
+    uint32_t entry_size = source_hash_entry_size();
+    std::vector<uint8_t> key_value(sizeof(entry_size) + padded_to_4(entry_size), 0);
+    memcpy(&key_value[0], &entry_size, sizeof(entry_size));
+    memcpy(&key_value[sizeof(entry_size)], KTX_SOURCE_HASH_KEY, sizeof(KTX_SOURCE_HASH_KEY));
+    memcpy(&key_value[sizeof(entry_size) + sizeof(KTX_SOURCE_HASH_KEY)], &texture.source_hash, sizeof(uint64_t));
+    header.bytes_of_key_value_data = (uint32_t)key_value.size();
+
+    FILE* file = fopen(filepath, "wb");
+    if (file == NULL) return false;
+
+    // compressed levels are whole blocks of 8 or 16 bytes, so never need padding
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(key_value.data(), 1, key_value.size(), file) == key_value.size();
+    for (const TextureLevel& level : texture.levels)
+    {
+        uint32_t image_size = (uint32_t)level.size;
+        written = written && fwrite(&image_size, sizeof(image_size), 1, file) == 1 &&
+            fwrite(&texture.data[level.offset], 1, level.size, file) == level.size;
+    }
+    return fclose(file) == 0 && written;
+}
+
+bool ktx_load(const char* filepath, TextureData& texture)
+{
+    FILE* file = fopen(filepath, "rb");
+    if (file == NULL) return false;
+
+    // only what ktx_save writes: one compressed 2D image with its mip chain
+    KtxHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) == 0 &&
+        header.endianness == KTX_ENDIANNESS && header.gl_type == 0 && header.gl_format == 0 &&
+        header.pixel_width > 0 && header.pixel_height > 0 && header.pixel_depth == 0 &&
+        header.number_of_array_elements == 0 && header.number_of_faces == 1 &&
+        header.number_of_mipmap_levels > 0 && header.number_of_mipmap_levels <= 32 &&
+        header.bytes_of_key_value_data < 65536;
+
+    std::vector<uint8_t> key_value(valid ? header.bytes_of_key_value_data : 0);
+    valid = valid && fread(key_value.data(), 1, key_value.size(), file) == key_value.size();
+
+    texture = TextureData();
+    texture.internal_format = header.gl_internal_format;
+    texture.compressed = true;
+
+    // other tools' keys are skipped, a file without the hash leaves it 0
+    for (size_t at = 0; valid && at + sizeof(uint32_t) <= key_value.size();)
+    {
+        uint32_t entry_size;
+        memcpy(&entry_size, &key_value[at], sizeof(entry_size));
+        at += sizeof(entry_size);
+        if (entry_size > key_value.size() - at) break;
+
+        if (entry_size == source_hash_entry_size() &&
+            memcmp(&key_value[at], KTX_SOURCE_HASH_KEY, sizeof(KTX_SOURCE_HASH_KEY)) == 0)
+        {
+            memcpy(&texture.source_hash, &key_value[at + sizeof(KTX_SOURCE_HASH_KEY)], sizeof(uint64_t));
+        }
+        at += padded_to_4(entry_size);
+    }
+
+    int width = header.pixel_width, height = header.pixel_height;
+    for (uint32_t i = 0; valid && i < header.number_of_mipmap_levels; i++)
+    {
+        uint32_t image_size = 0;
+        valid = fread(&image_size, sizeof(image_size), 1, file) == 1 && image_size > 0 && image_size < (1u << 30);
+        if (!valid) break;
+
+        texture.add_level(width, height, image_size);
+        valid = fread(&texture.data[texture.levels.back().offset], 1, image_size, file) == image_size;
+
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    fclose(file);
+    return valid;
+}
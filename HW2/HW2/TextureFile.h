@@ -0,0 +1,43 @@
+#pragma once
+
+#include "GlUtil.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct TextureLevel
+{
+    int width, height;
+    size_t offset, size; // into TextureData::data
+};
+
+// a texture's full mip chain in one allocation, ready for glTexImage2D or
+// glCompressedTexImage2D one level at a time
+struct TextureData
+{
+    GLenum internal_format = GL_RGBA; // a GL_COMPRESSED_* format when compressed
+    bool compressed = false;
+    uint64_t source_hash = 0; // of the image file a bake was made from, 0 if unknown
+    std::vector<TextureLevel> levels;
+    std::vector<uint8_t> data;
+
+    void add_level(int width, int height, size_t size)
+    {
+        TextureLevel level = { width, height, data.size(), size };
+        levels.push_back(level);
+        data.resize(data.size() + size);
+    }
+};
+
+// where the baked copy of an image lives, e.g. Cowboy1.png -> Cowboy1.ktx
+std::string baked_texture_path(const char* image_path);
+
+// whole file, e.g. an image to hash and then decode from memory
+bool read_file(const char* filepath, std::vector<uint8_t>& bytes);
+// FNV-1a, for telling whether a bake still matches its source image
+uint64_t texture_source_hash(const std::vector<uint8_t>& image_file);
+
+// compressed textures as KTX 1.1 files, source_hash is kept in the key/value data
+bool ktx_save(const char* filepath, const TextureData& texture);
+bool ktx_load(const char* filepath, TextureData& texture);
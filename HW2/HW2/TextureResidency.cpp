@@ -0,0 +1,117 @@
+#define GL_SILENCE_DEPRECATION
+
+#include "TextureResidency.h"
+#include "Profiler.h"
+
+void TextureResidency::initialise(TextureUploader* uploader, size_t budget_bytes)
+{
+    m_uploader = uploader;
+    m_budget_bytes = budget_bytes;
+}
+
+void TextureResidency::shutdown()
+{
+    for (TextureEntry& texture : m_textures)
+    {
+        if (texture.texture_id != 0) glDeleteTextures(1, &texture.texture_id);
+        texture.texture_id = 0;
+        texture.state = TEXTURE_UNLOADED;
+    }
+    m_resident_bytes = 0;
+}
+
+TextureHandle TextureResidency::add(const char* filepath)
+{
+    TextureEntry texture;
+    texture.filepath = filepath;
+    m_textures.push_back(texture);
+    return (TextureHandle)(m_textures.size() - 1);
+}
+
+void TextureResidency::load(TextureEntry& texture, bool urgent)
+{
+    texture.texture_id = m_uploader->request(texture.filepath.c_str(), urgent);
+    texture.state = TEXTURE_LOADING;
+    texture.urgent = urgent;
+}
+
+void TextureResidency::prefetch(TextureHandle handle)
+{
+    TextureEntry& texture = m_textures[handle];
+    if (texture.state == TEXTURE_UNLOADED) load(texture, false);
+}
+
+// few textures are ever loading at once, so a scan per upload is fine
+void TextureResidency::account_uploads()
+{
+    for (const UploadedTexture& uploaded : m_uploaded)
+    {
+        for (TextureEntry& texture : m_textures)
+        {
+            if (texture.texture_id != uploaded.texture_id || texture.state != TEXTURE_LOADING) continue;
+            if (uploaded.failed)
+            {
+                texture.state = TEXTURE_FAILED;
+                break;
+            }
+            texture.bytes = uploaded.bytes;
+            texture.state = TEXTURE_RESIDENT;
+            m_resident_bytes += uploaded.bytes;
+            break;
+        }
+    }
+    m_uploaded.clear();
+}
+
+void TextureResidency::begin_frame()
+{
+    m_uploader->update(&m_uploaded);
+    account_uploads();
+}
+
+GLuint TextureResidency::use(TextureHandle handle)
+{
+    TextureEntry& texture = m_textures[handle];
+    texture.last_used_frame = m_frame;
+
+    // on screen, so it jumps the queue
+    if (texture.state == TEXTURE_UNLOADED) load(texture, true);
+    else if (texture.state == TEXTURE_LOADING && !texture.urgent)
+    {
+        m_uploader->promote(texture.texture_id);
+        texture.urgent = true;
+    }
+    return texture.texture_id;
+}
+
+void TextureResidency::end_frame()
+{
+    while (m_resident_bytes > m_budget_bytes)
+    {
+        // least recently drawn; loading textures can't be evicted until their upload lands
+        TextureEntry* oldest = NULL;
+        for (TextureEntry& texture : m_textures)
+        {
+            if (texture.state != TEXTURE_RESIDENT || texture.last_used_frame == m_frame) continue;
+            if (oldest == NULL || texture.last_used_frame < oldest->last_used_frame) oldest = &texture;
+        }
+
+        // everything resident is on screen, going over budget beats drawing placeholders
+        if (oldest == NULL) break;
+
+        glDeleteTextures(1, &oldest->texture_id);
+        oldest->texture_id = 0;
+        oldest->state = TEXTURE_UNLOADED;
+        m_resident_bytes -= oldest->bytes;
+        m_eviction_count++;
+    }
+
+    profiler_record_counter("texture_resident_kb", (int64_t)(m_resident_bytes / 1024));
+    m_frame++;
+}
+
+void TextureResidency::finish()
+{
+    m_uploader->finish(&m_uploaded);
+    account_uploads();
+}
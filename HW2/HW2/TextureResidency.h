@@ -0,0 +1,73 @@
+#pragma once
+
+#include "TextureUploader.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef uint32_t TextureHandle;
+
+// Keeps textures on the GPU only while they're used, within a memory budget.
+// Sprites refer to textures by handle; use() marks a texture as drawn this
+// frame and loads it if it isn't resident, ahead of anything merely
+// prefetched (moving up a prefetch of it that's still waiting), while the
+// sprite draws a placeholder. An image that fails to load keeps the
+// placeholder and isn't asked for again. end_frame() evicts the textures
+// drawn longest ago until the resident ones fit the budget again; anything
+// drawn in the current frame is never evicted. Runs on the thread with the
+// GL context.
+class TextureResidency
+{
+private:
+    enum TextureState
+    {
+        TEXTURE_UNLOADED,
+        TEXTURE_LOADING,
+        TEXTURE_RESIDENT,
+        TEXTURE_FAILED // the image couldn't be loaded, draws its placeholder from now on
+    };
+
+    struct TextureEntry
+    {
+        std::string filepath;
+        GLuint texture_id = 0;
+        size_t bytes = 0;
+        uint64_t last_used_frame = 0;
+        TextureState state = TEXTURE_UNLOADED;
+        bool urgent = false; // loading ahead of prefetches
+    };
+
+    TextureUploader* m_uploader = NULL;
+    size_t m_budget_bytes = 0;
+    size_t m_resident_bytes = 0;
+    uint64_t m_frame = 1;
+    int m_eviction_count = 0;
+
+    std::vector<TextureEntry> m_textures;
+    std::vector<UploadedTexture> m_uploaded;
+
+    void load(TextureEntry& texture, bool urgent);
+    void account_uploads();
+
+public:
+    void initialise(TextureUploader* uploader, size_t budget_bytes);
+    // deletes every texture, resident or still loading
+    void shutdown();
+
+    // registers an image without loading it
+    TextureHandle add(const char* filepath);
+    // starts loading a texture that's likely to be drawn soon
+    void prefetch(TextureHandle handle);
+
+    // picks up finished uploads, call before the frame's use() calls
+    void begin_frame();
+    // the GL texture to draw this frame, a placeholder until it's loaded
+    GLuint use(TextureHandle handle);
+    void end_frame();
+
+    // blocks until every texture that's loading is resident
+    void finish();
+
+    size_t get_resident_bytes() const { return m_resident_bytes; }
+    int get_eviction_count() const { return m_eviction_count; }
+};
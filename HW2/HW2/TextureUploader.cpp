@@ -0,0 +1,297 @@
+#define GL_SILENCE_DEPRECATION
+
+#include "TextureUploader.h"
+#include "Mipmap.h"
+#include "Profiler.h"
+#include "stb_image.h"
+#include <cstdio>
+#include <cstring>
+
+const GLuint64 TEXTURE_UPLOAD_WAIT_NS = 1000000;
+
+void TextureUploader::start()
+{
+    // without fences the buffers can't be reused safely, so pixels go
+    // straight from client memory like before
+    m_use_fences = gl_version() >= 32 || gl_extension_supported("GL_ARB_sync");
+    m_supports_s3tc = gl_extension_supported("GL_EXT_texture_compression_s3tc");
+    m_supports_etc2 = gl_version() >= 43 || gl_extension_supported("GL_ARB_ES3_compatibility");
+    if (m_use_fences)
+    {
+        for (UploadBuffer& buffer : m_buffers) glGenBuffers(1, &buffer.buffer);
+    }
+    else
+    {
+        printf("Fence sync not supported, uploading textures without pixel buffers\n");
+    }
+
+    m_running = true;
+    m_thread = std::thread(&TextureUploader::run, this);
+}
+
+void TextureUploader::stop()
+{
+    if (!m_running) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+
+    m_decoded.clear();
+    m_requests.clear();
+
+    for (UploadBuffer& buffer : m_buffers)
+    {
+        if (buffer.fence != NULL) glDeleteSync(buffer.fence);
+        if (buffer.buffer != 0) glDeleteBuffers(1, &buffer.buffer);
+        buffer = UploadBuffer();
+    }
+}
+
+GLuint TextureUploader::request(const char* filepath, bool urgent)
+{
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+
+    const unsigned char placeholder[4] = { 0, 0, 0, 0 };
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+
+    // NEAREST better for pixel art
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    DecodedImage image;
+    image.texture_id = texture_id;
+    image.filepath = filepath;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (urgent) m_requests.push_front(std::move(image));
+        else m_requests.push_back(std::move(image));
+    }
+    m_condition.notify_one();
+
+    m_pending_count++;
+    return texture_id;
+}
+
+void TextureUploader::promote(GLuint texture_id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto request = m_requests.begin(); request != m_requests.end(); ++request)
+    {
+        if (request->texture_id != texture_id) continue;
+
+        if (request != m_requests.begin())
+        {
+            DecodedImage image = std::move(*request);
+            m_requests.erase(request);
+            m_requests.push_front(std::move(image));
+        }
+        return;
+    }
+}
+
+void TextureUploader::run()
+{
+    profiler_set_thread_name("texture_decode");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return !m_running || !m_requests.empty(); });
+        if (!m_running) return;
+
+        DecodedImage image = std::move(m_requests.front());
+        m_requests.pop_front();
+        lock.unlock();
+
+        decode(image);
+
+        lock.lock();
+        m_decoded.push_back(std::move(image));
+    }
+}
+
+void TextureUploader::decode(DecodedImage& image)
+{
+    PROFILE_ZONE("decode_texture");
+
+    // a baked copy next to the image is used as is, if the GPU knows its format
+    // and it was baked from the image as it is now; without the image it's all there is
+    std::vector<uint8_t> image_file;
+    bool has_image = read_file(image.filepath.c_str(), image_file);
+    std::string baked_path = baked_texture_path(image.filepath.c_str());
+    if (ktx_load(baked_path.c_str(), image.texture))
+    {
+        GLenum format = image.texture.internal_format;
+        bool s3tc = format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        bool etc2 = format == GL_COMPRESSED_RGB8_ETC2 || format == GL_COMPRESSED_RGBA8_ETC2_EAC;
+        bool current = !has_image || image.texture.source_hash == texture_source_hash(image_file);
+        if (!current) printf("%s is out of date with %s, rebake it with --bake\n", baked_path.c_str(), image.filepath.c_str());
+        else if ((s3tc && m_supports_s3tc) || (etc2 && m_supports_etc2)) return;
+    }
+
+    image.texture = TextureData();
+    int width, height, number_of_components;
+    unsigned char* pixels = has_image ? stbi_load_from_memory(image_file.data(), (int)image_file.size(),
+        &width, &height, &number_of_components, STBI_rgb_alpha) : NULL;
+    if (pixels == NULL)
+    {
+        printf("Unable to load image %s. Make sure the path is correct.\n", image.filepath.c_str());
+        return;
+    }
+
+    image.texture.add_level(width, height, (size_t)width * height * 4);
+    memcpy(image.texture.data.data(), pixels, image.texture.data.size());
+    stbi_image_free(pixels);
+
+    // on this thread rather than glGenerateMipmap, which stalls the render thread
+    build_mip_chain(image.texture);
+}
+
+// frees buffers whose uploads the driver has finished with
+void TextureUploader::retire_uploads(bool wait)
+{
+    for (UploadBuffer& buffer : m_buffers)
+    {
+        if (buffer.fence == NULL) continue;
+
+        GLenum result = glClientWaitSync(buffer.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+            wait ? TEXTURE_UPLOAD_WAIT_NS : 0);
+        if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) continue;
+
+        glDeleteSync(buffer.fence);
+        buffer.fence = NULL;
+    }
+}
+
+void TextureUploader::update(std::vector<UploadedTexture>* uploaded)
+{
+    if (m_pending_count == 0) return;
+    PROFILE_ZONE("texture_upload");
+
+    if (m_use_fences) retire_uploads(false);
+
+    size_t uploaded_bytes = 0;
+    while (uploaded_bytes < TEXTURE_UPLOAD_BYTES_PER_UPDATE)
+    {
+        UploadBuffer* free_buffer = NULL;
+        if (m_use_fences)
+        {
+            for (UploadBuffer& buffer : m_buffers)
+            {
+                if (buffer.fence == NULL)
+                {
+                    free_buffer = &buffer;
+                    break;
+                }
+            }
+            if (free_buffer == NULL) return;
+        }
+
+        DecodedImage image;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_decoded.empty()) return;
+            image = std::move(m_decoded.front());
+            m_decoded.pop_front();
+        }
+
+        // a failed decode keeps its placeholder
+        if (!image.texture.levels.empty())
+        {
+            UploadedTexture texture = { image.texture_id, upload(image, free_buffer), false };
+            if (uploaded != NULL) uploaded->push_back(texture);
+            uploaded_bytes += image.texture.data.size();
+        }
+        else if (uploaded != NULL)
+        {
+            UploadedTexture texture = { image.texture_id, 0, true };
+            uploaded->push_back(texture);
+        }
+        m_pending_count--;
+    }
+}
+
+// returns the texture's size on the GPU
+size_t TextureUploader::upload(const DecodedImage& image, UploadBuffer* buffer)
+{
+    const TextureData& texture = image.texture;
+    size_t size = texture.data.size();
+
+    // replace the placeholder's storage before a pixel buffer is bound, while NULL still means no data
+    glBindTexture(GL_TEXTURE_2D, image.texture_id);
+    if (!texture.compressed)
+    {
+        for (size_t i = 0; i < texture.levels.size(); i++)
+        {
+            glTexImage2D(GL_TEXTURE_2D, (GLint)i, GL_RGBA, texture.levels[i].width, texture.levels[i].height, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        }
+    }
+
+    if (buffer != NULL)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->buffer);
+        if (buffer->capacity < size)
+        {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+            buffer->capacity = size;
+        }
+
+        // the fence said the GPU is done with this buffer, so this never waits
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped != NULL)
+        {
+            memcpy(mapped, texture.data.data(), size);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        else
+        {
+            // the driver couldn't map it (out of memory, lost context), upload from client memory instead
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            buffer = NULL;
+        }
+    }
+
+    for (size_t i = 0; i < texture.levels.size(); i++)
+    {
+        const TextureLevel& level = texture.levels[i];
+        // offsets into the bound buffer, or client memory without one
+        const void* pixels = buffer != NULL ? (const void*)level.offset : (const void*)&texture.data[level.offset];
+        if (texture.compressed)
+        {
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, texture.internal_format, level.width, level.height, 0,
+                (GLsizei)level.size, pixels);
+        }
+        else
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, (GLint)i, 0, 0, level.width, level.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+    }
+
+    // NEAREST better for pixel art, mips just stop far away sprites shimmering
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)texture.levels.size() - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.levels.size() > 1 ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST);
+
+    if (buffer != NULL)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        buffer->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    return size;
+}
+
+void TextureUploader::finish(std::vector<UploadedTexture>* uploaded)
+{
+    while (m_pending_count > 0)
+    {
+        update(uploaded);
+        if (m_use_fences) retire_uploads(true);
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "GlUtil.h"
+#include "TextureFile.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct UploadedTexture
+{
+    GLuint texture_id;
+    size_t bytes; // GPU memory the texture now takes
+    bool failed; // the image couldn't be loaded, the texture keeps its placeholder
+};
+
+// uploads in flight at once, each through its own pixel buffer object
+const int TEXTURE_UPLOAD_BUFFERS = 4;
+// most pixel data copied into upload buffers per update(), so a batch of big
+// images is spread over several frames instead of hitching one
+const size_t TEXTURE_UPLOAD_BYTES_PER_UPDATE = 4 * 1024 * 1024;
+
+// Loads textures without stalling the thread that draws. request() returns a
+// texture straight away holding a transparent 1x1 placeholder; a worker thread
+// decodes the image, or reads its baked .ktx if the GPU supports that format,
+// update() copies it into a pixel buffer object and issues glTexSubImage2D or
+// glCompressedTexImage2D from there, and a fence says when the driver is done
+// with the buffer so it can be reused. Everything but the decoding runs on the thread
+// with the GL context, which may change between calls but not during one.
+class TextureUploader
+{
+private:
+    struct DecodedImage
+    {
+        GLuint texture_id;
+        std::string filepath;
+        TextureData texture; // no levels if decoding failed
+    };
+
+    struct UploadBuffer
+    {
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        GLsync fence = NULL; // NULL when free
+    };
+
+    bool m_use_fences = false;
+    bool m_supports_s3tc = false,
+        m_supports_etc2 = false;
+    UploadBuffer m_buffers[TEXTURE_UPLOAD_BUFFERS];
+    int m_pending_count = 0; // requested and not yet uploaded, GL thread only
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running = false;
+    std::deque<DecodedImage> m_requests,
+        m_decoded;
+
+    void run();
+    void decode(DecodedImage& image);
+    void retire_uploads(bool wait);
+    size_t upload(const DecodedImage& image, UploadBuffer* buffer);
+
+public:
+    // needs a current GL context
+    void start();
+    // joins the worker and frees the upload buffers, needs the GL context
+    void stop();
+
+    // urgent requests are decoded before any others, e.g. for textures already on screen
+    GLuint request(const char* filepath, bool urgent = false);
+    // moves a request that's still waiting to be decoded to the front, for a
+    // prefetched texture that turned out to be on screen
+    void promote(GLuint texture_id);
+
+    // copies decoded images into the GPU's queue and retires finished uploads,
+    // call once a frame; textures that got their image, or failed to, are added to uploaded
+    void update(std::vector<UploadedTexture>* uploaded = NULL);
+
+    // blocks until every requested texture has been uploaded
+    void finish(std::vector<UploadedTexture>* uploaded = NULL);
+
+    int get_pending_count() const { return m_pending_count; }
+};
@@ -0,0 +1,47 @@
+#include "Transport.h"
+#include "Profiler.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/random.hpp"
+
+void LoopbackTransport::connect(LoopbackTransport& a, LoopbackTransport& b)
+{
+    a.m_peer = &b;
+    b.m_peer = &a;
+}
+
+void LoopbackTransport::set_conditions(float latency_ms, float jitter_ms, float loss)
+{
+    m_latency_ms = latency_ms;
+    m_jitter_ms = jitter_ms;
+    m_loss = loss;
+}
+
+void LoopbackTransport::send(const InputPacket& packet)
+{
+    if (m_peer == nullptr) return;
+    if (m_loss > 0.0f && glm::linearRand(0.0f, 1.0f) < m_loss) return;
+
+    float delay_ms = m_latency_ms;
+    if (m_jitter_ms > 0.0f) delay_ms += glm::linearRand(0.0f, m_jitter_ms);
+
+    InFlightPacket in_flight;
+    in_flight.deliver_at_ns = profiler_now_ns() + (uint64_t)(delay_ms * 1000000.0f);
+    in_flight.packet = packet;
+    m_peer->m_incoming.push_back(in_flight);
+}
+
+bool LoopbackTransport::receive(InputPacket& packet)
+{
+    // jitter can reorder packets, hand out whichever has arrived
+    uint64_t now = profiler_now_ns();
+    for (size_t i = 0; i < m_incoming.size(); i++)
+    {
+        if (m_incoming[i].deliver_at_ns > now) continue;
+
+        packet = m_incoming[i].packet;
+        m_incoming[i] = m_incoming.back();
+        m_incoming.pop_back();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// inputs a packet can carry, enough to resend everything the peer hasn't
+// acknowledged; the rollback window is checked against this
+const int PACKET_MAX_INPUTS = 64;
+
+// A player's inputs for ticks [first_tick, first_tick + input_count), plus the
+// number of the other player's ticks the sender has received so far. Inputs
+// are resent until they're acknowledged, so a lost packet only delays them.
+// checksum is the hash of the sender's state at checksum_tick, the latest tick
+// no prediction went into, for desync detection.
+struct InputPacket
+{
+    uint32_t first_tick;
+    uint32_t ack_tick;
+    uint32_t checksum_tick;
+    uint64_t checksum;
+    uint8_t input_count;
+    uint8_t inputs[PACKET_MAX_INPUTS];
+};
+
+// Unreliable, unordered delivery of input packets to the other player
+class Transport
+{
+public:
+    virtual ~Transport() {}
+
+    virtual void send(const InputPacket& packet) = 0;
+    // returns false once there is nothing left to receive right now
+    virtual bool receive(InputPacket& packet) = 0;
+};
+
+// In-process stand-in for a network connection. Two endpoints are connected to
+// each other and delay, jitter and drop packets like a real link would.
+class LoopbackTransport : public Transport
+{
+private:
+    struct InFlightPacket
+    {
+        uint64_t deliver_at_ns;
+        InputPacket packet;
+    };
+
+    LoopbackTransport* m_peer = nullptr;
+    std::vector<InFlightPacket> m_incoming;
+
+    float m_latency_ms = 0.0f;
+    float m_jitter_ms = 0.0f;
+    float m_loss = 0.0f;
+
+public:
+    static void connect(LoopbackTransport& a, LoopbackTransport& b);
+
+    // one-way latency, random extra delay of up to jitter_ms, and loss as a 0-1 probability
+    void set_conditions(float latency_ms, float jitter_ms, float loss);
+
+    void send(const InputPacket& packet) override;
+    bool receive(InputPacket& packet) override;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+// Every benchmark prints one CSV row per measurement so runs of the
+// different SIMD variants can be concatenated and diffed by scripts:
+//   variant,benchmark,ns_per_op,iterations
+#ifndef BENCH_VARIANT
+#define BENCH_VARIANT "default"
+#endif
+
+extern volatile float g_sink; // keeps the optimizer from dropping the work
+
+inline void print_csv_header()
+{
+    std::printf("variant,benchmark,ns_per_op,iterations\n");
+}
+
+inline void print_csv_row(const char* benchmark, double ns_per_op, long long iterations)
+{
+    std::printf("%s,%s,%.4f,%lld\n", BENCH_VARIANT, benchmark, ns_per_op, iterations);
+}
+
+// runs body() repetitions times, body does operations_per_call operations
+template <typename Body>
+double time_ns_per_op(Body body, long long repetitions, long long operations_per_call)
+{
+    body(); // warm caches and page in the data before timing
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < repetitions; i++) body();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / (double(repetitions) * double(operations_per_call));
+}
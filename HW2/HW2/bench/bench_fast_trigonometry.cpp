@@ -0,0 +1,64 @@
+/**
+* Times the glm::fastSin / fastCos array kernels against std::sin / std::cos
+* and reports the max absolute error over the sampled range.
+**/
+
+#include <cmath>
+#include <vector>
+#include "glm/glm.hpp"
+#include "glm/gtx/fast_trigonometry.hpp"
+#include "bench_common.h"
+
+const int SAMPLE_COUNT = 1 << 16;
+const int REPETITIONS = 200;
+const float ANGLE_RANGE = 8.0f * 3.14159265f; // a few turns either way, like a spinning sprite
+
+volatile float g_sink = 0.0f;
+
+template <typename Kernel>
+double time_kernel(Kernel kernel, std::vector<float>& out)
+{
+    return time_ns_per_op([&]() {
+        kernel();
+        g_sink = g_sink + out[0];
+    }, REPETITIONS, SAMPLE_COUNT);
+}
+
+double max_error(const std::vector<float>& result, const std::vector<float>& reference)
+{
+    double error = 0.0;
+    for (size_t i = 0; i < result.size(); i++)
+        error = std::fmax(error, std::fabs(double(result[i]) - double(reference[i])));
+    return error;
+}
+
+int main()
+{
+    std::vector<float> angles(SAMPLE_COUNT), reference(SAMPLE_COUNT), result(SAMPLE_COUNT);
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+        angles[i] = -ANGLE_RANGE + 2.0f * ANGLE_RANGE * float(i) / float(SAMPLE_COUNT);
+
+    print_csv_header();
+
+    double std_sin = time_kernel([&]() {
+        for (int i = 0; i < SAMPLE_COUNT; i++) reference[i] = std::sin(angles[i]);
+    }, reference);
+    double fast_sin = time_kernel([&]() {
+        glm::fastSin(angles.data(), result.data(), SAMPLE_COUNT);
+    }, result);
+    print_csv_row("std_sin", std_sin, (long long)REPETITIONS * SAMPLE_COUNT);
+    print_csv_row("fast_sin", fast_sin, (long long)REPETITIONS * SAMPLE_COUNT);
+    std::fprintf(stderr, "fastSin max error %.3g\n", max_error(result, reference));
+
+    double std_cos = time_kernel([&]() {
+        for (int i = 0; i < SAMPLE_COUNT; i++) reference[i] = std::cos(angles[i]);
+    }, reference);
+    double fast_cos = time_kernel([&]() {
+        glm::fastCos(angles.data(), result.data(), SAMPLE_COUNT);
+    }, result);
+    print_csv_row("std_cos", std_cos, (long long)REPETITIONS * SAMPLE_COUNT);
+    print_csv_row("fast_cos", fast_cos, (long long)REPETITIONS * SAMPLE_COUNT);
+    std::fprintf(stderr, "fastCos max error %.3g\n", max_error(result, reference));
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+* Times the glm operations the game leans on. Built once per SIMD variant
+* (see CMakeLists.txt) so GLM_FORCE_PURE, SSE2 and AVX2 paths can be compared.
+**/
+
+#include <vector>
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/random.hpp"
+#include "bench_common.h"
+
+volatile float g_sink = 0.0f;
+
+const int ELEMENT_COUNT = 1024; // small enough to stay in L1/L2, we time the math not memory
+const long long REPETITIONS = 2000;
+
+int main()
+{
+    glm::seedRand(1234);
+
+    std::vector<glm::mat4> matrices_a(ELEMENT_COUNT), matrices_b(ELEMENT_COUNT), matrices_out(ELEMENT_COUNT);
+    std::vector<glm::vec4> vectors_a(ELEMENT_COUNT), vectors_b(ELEMENT_COUNT), vectors_out(ELEMENT_COUNT);
+    std::vector<glm::quat> quats_a(ELEMENT_COUNT), quats_b(ELEMENT_COUNT), quats_out(ELEMENT_COUNT);
+    std::vector<glm::vec3> offsets(ELEMENT_COUNT);
+    std::vector<float> scalars(ELEMENT_COUNT);
+
+    for (int i = 0; i < ELEMENT_COUNT; i++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            matrices_a[i][c] = glm::linearRand(glm::vec4(-1.0f), glm::vec4(1.0f));
+            matrices_b[i][c] = glm::linearRand(glm::vec4(-1.0f), glm::vec4(1.0f));
+        }
+        matrices_a[i] += glm::mat4(4.0f); // keep them well conditioned for inverse
+        vectors_a[i] = glm::linearRand(glm::vec4(-1.0f), glm::vec4(1.0f));
+        vectors_b[i] = glm::linearRand(glm::vec4(-1.0f), glm::vec4(1.0f));
+        quats_a[i] = glm::normalize(glm::quat(vectors_a[i].w, vectors_a[i].x, vectors_a[i].y, vectors_a[i].z));
+        quats_b[i] = glm::normalize(glm::quat(vectors_b[i].w, vectors_b[i].x, vectors_b[i].y, vectors_b[i].z));
+        offsets[i] = glm::vec3(vectors_a[i]);
+        scalars[i] = glm::linearRand(0.0f, 1.0f);
+    }
+
+    print_csv_header();
+
+    print_csv_row("mat4_mul", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++) matrices_out[i] = matrices_a[i] * matrices_b[i];
+        g_sink = g_sink + matrices_out[0][0][0];
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    print_csv_row("mat4_inverse", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++) matrices_out[i] = glm::inverse(matrices_a[i]);
+        g_sink = g_sink + matrices_out[0][0][0];
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    print_csv_row("mat4_transpose", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++) matrices_out[i] = glm::transpose(matrices_a[i]);
+        g_sink = g_sink + matrices_out[0][0][0];
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    print_csv_row("mat4_mul_vec4", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++) vectors_out[i] = matrices_a[i] * vectors_a[i];
+        g_sink = g_sink + vectors_out[0].x;
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    print_csv_row("vec4_dot", time_ns_per_op([&]() {
+        float sum = 0.0f;
+        for (int i = 0; i < ELEMENT_COUNT; i++) sum += glm::dot(vectors_a[i], vectors_b[i]);
+        g_sink = g_sink + sum;
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    print_csv_row("vec4_normalize", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++) vectors_out[i] = glm::normalize(vectors_a[i]);
+        g_sink = g_sink + vectors_out[0].x;
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    print_csv_row("quat_slerp", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++) quats_out[i] = glm::slerp(quats_a[i], quats_b[i], scalars[i]);
+        g_sink = g_sink + quats_out[0].x;
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    print_csv_row("ortho", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++)
+            matrices_out[i] = glm::ortho(-5.0f - scalars[i], 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
+        g_sink = g_sink + matrices_out[0][0][0];
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    // the per-sprite model matrix the game rebuilds every frame
+    print_csv_row("scale_translate", time_ns_per_op([&]() {
+        for (int i = 0; i < ELEMENT_COUNT; i++)
+            matrices_out[i] = glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(scalars[i])), offsets[i]);
+        g_sink = g_sink + matrices_out[0][0][0];
+    }, REPETITIONS, ELEMENT_COUNT), REPETITIONS * ELEMENT_COUNT);
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+# Runs each benchmark in BENCH_COMMANDS and merges their CSV output,
+# keeping a single header line, into BENCH_OUTPUT.
+# BENCH_COMMANDS is a '|' separated list of executables.
+
+string(REPLACE "|" ";" BENCH_COMMANDS "${BENCH_COMMANDS}")
+
+file(WRITE ${BENCH_OUTPUT} "variant,benchmark,ns_per_op,iterations\n")
+
+foreach(command ${BENCH_COMMANDS})
+	message(STATUS "Running ${command}")
+	execute_process(COMMAND ${command} OUTPUT_VARIABLE output RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "${command} failed with ${result}")
+	endif()
+	string(REGEX REPLACE "^variant,benchmark,ns_per_op,iterations\n" "" output "${output}")
+	file(APPEND ${BENCH_OUTPUT} "${output}")
+endforeach()
+
+message(STATUS "Benchmark results written to ${BENCH_OUTPUT}")
@@ -14,6 +14,7 @@
 #pragma once
 
 // Dependency:
+#include <cstddef>
 #include "type_precision.hpp"
 
 #if GLM_MESSAGES == GLM_ENABLE && !defined(GLM_EXT_INCLUDED)
@@ -722,6 +723,35 @@ namespace glm
 	GLM_FUNC_DECL u32vec2 unpackUint2x32(uint64 p);
 
 
+	/// Convert Count floats to 16-bit floating-point values, e.g. to halve a vertex stream before upload.
+	/// Uses F16C, 8 values per step, when the compiler targets it, and gives the same bits without it.
+	/// Differs from packHalf1x16 on ties, normal or denormal, which round to nearest even rather than
+	/// away from zero, and on NaNs, which come out quiet keeping the top 10 bits of their payload.
+	///
+	/// @see gtc_packing
+	/// @see void unpackHalf(uint16 const* In, float* Out, std::size_t Count)
+	GLM_FUNC_DECL void packHalf(float const* In, uint16* Out, std::size_t Count);
+
+	/// Convert Count 16-bit floating-point values to floats, exactly.
+	/// Same as unpackHalf1x16 per value except that signaling NaNs come out quiet, as F16C does.
+	///
+	/// @see gtc_packing
+	/// @see void packHalf(float const* In, uint16* Out, std::size_t Count)
+	GLM_FUNC_DECL void unpackHalf(uint16 const* In, float* Out, std::size_t Count);
+
+	/// Clamp Count floats to [0, 1] and convert them to 8-bit normalized values, same as packUnorm1x8 per value.
+	/// Converts 16 values per step with SSE2 when intrinsics are enabled.
+	///
+	/// @see gtc_packing
+	/// @see void unpackUnorm(uint8 const* In, float* Out, std::size_t Count)
+	GLM_FUNC_DECL void packUnorm(float const* In, uint8* Out, std::size_t Count);
+
+	/// Convert Count 8-bit normalized values to floats, same as unpackUnorm1x8 per value.
+	///
+	/// @see gtc_packing
+	/// @see void packUnorm(float const* In, uint8* Out, std::size_t Count)
+	GLM_FUNC_DECL void unpackUnorm(uint8 const* In, float* Out, std::size_t Count);
+
 	/// @}
 }// namespace glm
 
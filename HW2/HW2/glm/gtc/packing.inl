@@ -7,6 +7,8 @@
 #include "../vec3.hpp"
 #include "../vec4.hpp"
 #include "../detail/type_half.hpp"
+#include "../simd/packing.h"
+#include <cstddef>
 #include <cstring>
 #include <limits>
 
@@ -350,6 +352,52 @@ namespace detail
 			return vec<4, float, Q>(detail::toFloat32(v.x), detail::toFloat32(v.y), detail::toFloat32(v.z), detail::toFloat32(v.w));
 		}
 	};
+
+	// What F16C's vcvtps2ph computes, for the values the bulk packHalf converts without it:
+	// round to nearest even, overflow to infinity, NaNs quieted keeping the top of their payload.
+	GLM_FUNC_QUALIFIER uint16 packHalfNearestEven(float v)
+	{
+		uint32 Bits = 0;
+		memcpy(&Bits, &v, sizeof(Bits));
+		uint32 const Sign = (Bits >> 16) & 0x8000u;
+		uint32 const Abs = Bits & 0x7fffffffu;
+
+		if(Abs > 0x7f800000u) // NaN
+			return static_cast<uint16>(Sign | 0x7e00u | ((Abs >> 13) & 0x03ffu));
+		if(Abs >= 0x477ff000u) // 65520 and up round to infinity
+			return static_cast<uint16>(Sign | 0x7c00u);
+
+		uint32 Result = 0;
+		uint32 Shift = 13;
+		if(Abs >= 0x38800000u) // normal half, rebias the exponent and drop 13 bits
+			Result = Abs - 0x38000000u;
+		else if(Abs >= 0x33000000u) // denormal half, counts of 2^-24 from the full significand
+		{
+			Result = (Abs & 0x007fffffu) | 0x00800000u;
+			Shift = 126 - (Abs >> 23);
+		}
+		else // under half the smallest denormal
+			return static_cast<uint16>(Sign);
+
+		uint32 const Dropped = Result & ((1u << Shift) - 1u);
+		uint32 const Half = 1u << (Shift - 1u);
+		Result >>= Shift;
+		if(Dropped > Half || (Dropped == Half && (Result & 1u)))
+			++Result; // a carry out of the significand steps the exponent, as it should
+		return static_cast<uint16>(Sign | Result);
+	}
+
+	// What F16C's vcvtph2ps computes: exact, but signaling NaNs come out quiet
+	GLM_FUNC_QUALIFIER float unpackHalfQuiet(uint16 v)
+	{
+		if((v & 0x7c00u) != 0x7c00u || (v & 0x03ffu) == 0)
+			return toFloat32(static_cast<hdata>(v));
+
+		uint32 const Bits = (static_cast<uint32>(v & 0x8000u) << 16) | 0x7fc00000u | (static_cast<uint32>(v & 0x03ffu) << 13);
+		float Result = 0.0f;
+		memcpy(&Result, &Bits, sizeof(Result));
+		return Result;
+	}
 }//namespace detail
 
 	GLM_FUNC_QUALIFIER uint8 packUnorm1x8(float v)
@@ -934,5 +982,65 @@ namespace detail
 		memcpy(&Unpack, &p, sizeof(Unpack));
 		return Unpack;
 	}
+	GLM_FUNC_QUALIFIER void packHalf(float const* In, uint16* Out, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if GLM_SIMD_HAS_F16C
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i const Lo = _mm_cvtps_ph(_mm_loadu_ps(In + i + 0), _MM_FROUND_TO_NEAREST_INT);
+				__m128i const Hi = _mm_cvtps_ph(_mm_loadu_ps(In + i + 4), _MM_FROUND_TO_NEAREST_INT);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + i), _mm_unpacklo_epi64(Lo, Hi));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Out[i] = detail::packHalfNearestEven(In[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackHalf(uint16 const* In, float* Out, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if GLM_SIMD_HAS_F16C
+			for(; i + 8 <= Count; i += 8)
+			{
+				__m128i const Packed = _mm_loadu_si128(reinterpret_cast<__m128i const*>(In + i));
+				_mm_storeu_ps(Out + i + 0, _mm_cvtph_ps(Packed));
+				_mm_storeu_ps(Out + i + 4, _mm_cvtph_ps(_mm_unpackhi_epi64(Packed, Packed)));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Out[i] = detail::unpackHalfQuiet(In[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void packUnorm(float const* In, uint8* Out, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if GLM_ARCH & GLM_ARCH_SSE2_BIT
+			for(; i + 16 <= Count; i += 16)
+			{
+				glm_uvec4 const Packed = glm_vec4_pack_unorm8x16(
+					_mm_loadu_ps(In + i + 0), _mm_loadu_ps(In + i + 4),
+					_mm_loadu_ps(In + i + 8), _mm_loadu_ps(In + i + 12));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + i), Packed);
+			}
+#		endif
+		for(; i < Count; ++i)
+			Out[i] = packUnorm1x8(In[i]);
+	}
+
+	GLM_FUNC_QUALIFIER void unpackUnorm(uint8 const* In, float* Out, std::size_t Count)
+	{
+		std::size_t i = 0;
+#		if GLM_ARCH & GLM_ARCH_SSE2_BIT
+			for(; i + 16 <= Count; i += 16)
+			{
+				glm_uvec4 Packed = _mm_loadu_si128(reinterpret_cast<__m128i const*>(In + i));
+				for(std::size_t j = 0; j < 16; j += 4, Packed = _mm_srli_si128(Packed, 4))
+					_mm_storeu_ps(Out + i + j, glm_vec4_unpack_unorm8x4(Packed));
+			}
+#		endif
+		for(; i < Count; ++i)
+			Out[i] = unpackUnorm1x8(In[i]);
+	}
 }//namespace glm
 
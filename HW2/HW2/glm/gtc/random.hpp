@@ -10,10 +10,17 @@
 /// Include <glm/gtc/random.hpp> to use the features of this extension.
 ///
 /// Generate random number from various distribution methods.
+///
+/// Values are drawn from a per-thread xoshiro128 engine rather than std::rand,
+/// independent of std::srand. A thread that never calls seedRand gets the next
+/// of a sequence of streams when it first draws, so which stream it gets
+/// depends on thread scheduling: callers that need reproducible values must
+/// call seedRand on the drawing thread first.
 
 #pragma once
 
 // Dependency:
+#include <cstddef>
 #include "../ext/scalar_int_sized.hpp"
 #include "../ext/scalar_uint_sized.hpp"
 #include "../detail/qualifier.hpp"
@@ -76,6 +83,51 @@ namespace glm
 	template<typename T>
 	GLM_FUNC_DECL vec<3, T, defaultp> ballRand(T Radius);
 
+	/// Seed the random engine of the calling thread, which then draws the same
+	/// values for the same seed on any thread. Other threads keep their own
+	/// engine and are not affected.
+	///
+	/// @see gtc_random
+	GLM_FUNC_DECL void seedRand(uint64 Seed);
+
+	/// Fill Out with Count vectors in the interval [Min, Max[, according a linear distribution
+	///
+	/// @tparam T Value type. Currently supported: float or double.
+	/// @see gtc_random
+	template<length_t L, typename T, qualifier Q>
+	GLM_FUNC_DECL void linearRand(vec<L, T, Q>* Out, std::size_t Count, vec<L, T, Q> const& Min, vec<L, T, Q> const& Max);
+
+	/// Fill Out with Count vectors according a gaussian distribution of the given mean and standard deviation
+	///
+	/// @tparam T Value type. Currently supported: float or double.
+	/// @see gtc_random
+	template<length_t L, typename T, qualifier Q>
+	GLM_FUNC_DECL void gaussRand(vec<L, T, Q>* Out, std::size_t Count, vec<L, T, Q> const& Mean, vec<L, T, Q> const& Deviation);
+
+	/// Fill Out with Count 2D vectors regulary distributed on a circle of a given radius
+	///
+	/// @see gtc_random
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void circularRand(vec<2, T, Q>* Out, std::size_t Count, T Radius);
+
+	/// Fill Out with Count 2D vectors regulary distributed within the area of a disk of a given radius
+	///
+	/// @see gtc_random
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void diskRand(vec<2, T, Q>* Out, std::size_t Count, T Radius);
+
+	/// Fill Out with Count 3D vectors regulary distributed on a sphere of a given radius
+	///
+	/// @see gtc_random
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void sphericalRand(vec<3, T, Q>* Out, std::size_t Count, T Radius);
+
+	/// Fill Out with Count 3D vectors regulary distributed within the volume of a ball of a given radius
+	///
+	/// @see gtc_random
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void ballRand(vec<3, T, Q>* Out, std::size_t Count, T Radius);
+
 	/// @}
 }//namespace glm
 
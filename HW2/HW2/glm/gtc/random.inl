@@ -1,86 +1,203 @@
 #include "../geometric.hpp"
 #include "../exponential.hpp"
 #include "../trigonometric.hpp"
+#include "../common.hpp"
 #include "../detail/type_vec1.hpp"
-#include <cstdlib>
-#include <ctime>
+#include <cstddef>
 #include <cassert>
 #include <cmath>
+#if GLM_LANG & GLM_LANG_CXX11_FLAG
+#	include <atomic>
+#endif
 
 namespace glm{
 namespace detail
 {
-	template <length_t L, typename T, qualifier Q>
-	struct compute_rand
+	// xoshiro128** for single draws and four interleaved xoshiro128+ lanes for
+	// batch fills. Both live in a per-thread state so concurrent callers never
+	// contend on a global lock nor perturb each other's sequence.
+	struct rand_state
 	{
-		GLM_FUNC_QUALIFIER static vec<L, T, Q> call();
-	};
+		uint32 Scalar[4];
+		uint32 Lane[4][4];
 
-	template <qualifier P>
-	struct compute_rand<1, uint8, P>
-	{
-		GLM_FUNC_QUALIFIER static vec<1, uint8, P> call()
+		// each thread's state gets the next stream number, so threads that
+		// never call seedRand still draw different sequences; the numbers go
+		// in first-draw order, so only seedRand makes a thread reproducible
+		GLM_FUNC_QUALIFIER rand_state()
 		{
-			return vec<1, uint8, P>(
-				std::rand() % std::numeric_limits<uint8>::max());
+			seed(static_cast<uint64>(0x853C49E6748FEA9Bull) + next_stream());
 		}
-	};
 
-	template <qualifier P>
-	struct compute_rand<2, uint8, P>
-	{
-		GLM_FUNC_QUALIFIER static vec<2, uint8, P> call()
+		GLM_FUNC_QUALIFIER static uint64 next_stream()
+		{
+#			if GLM_LANG & GLM_LANG_CXX11_FLAG
+				static std::atomic<uint64> Streams(0);
+				return Streams.fetch_add(1, std::memory_order_relaxed);
+#			else
+				return 0;
+#			endif
+		}
+
+		// splitmix64 expands the seed so that nearby seeds give unrelated streams
+		GLM_FUNC_QUALIFIER static uint64 splitmix64(uint64& x)
+		{
+			uint64 z = (x += static_cast<uint64>(0x9E3779B97F4A7C15ull));
+			z = (z ^ (z >> 30)) * static_cast<uint64>(0xBF58476D1CE4E5B9ull);
+			z = (z ^ (z >> 27)) * static_cast<uint64>(0x94D049BB133111EBull);
+			return z ^ (z >> 31);
+		}
+
+		GLM_FUNC_QUALIFIER void seed(uint64 Seed)
+		{
+			for(length_t i = 0; i < 2; ++i)
+			{
+				uint64 const Word = splitmix64(Seed);
+				Scalar[i * 2 + 0] = static_cast<uint32>(Word);
+				Scalar[i * 2 + 1] = static_cast<uint32>(Word >> 32);
+			}
+			for(length_t i = 0; i < 4; ++i)
+			for(length_t j = 0; j < 4; j += 2)
+			{
+				uint64 const Word = splitmix64(Seed);
+				Lane[i][j + 0] = static_cast<uint32>(Word);
+				Lane[i][j + 1] = static_cast<uint32>(Word >> 32);
+			}
+		}
+
+		GLM_FUNC_QUALIFIER static uint32 rotl(uint32 x, int k)
+		{
+			return (x << k) | (x >> (32 - k));
+		}
+
+		GLM_FUNC_QUALIFIER uint32 next()
+		{
+			uint32 const Result = rotl(Scalar[1] * 5u, 7) * 9u;
+			uint32 const t = Scalar[1] << 9;
+			Scalar[2] ^= Scalar[0];
+			Scalar[3] ^= Scalar[1];
+			Scalar[1] ^= Scalar[2];
+			Scalar[0] ^= Scalar[3];
+			Scalar[2] ^= t;
+			Scalar[3] = rotl(Scalar[3], 11);
+			return Result;
+		}
+
+		// Lane[k][i] is word k of lane i, so each row maps to one SIMD register
+		GLM_FUNC_QUALIFIER void next4(uint32 Out[4])
 		{
-			return vec<2, uint8, P>(
-				std::rand() % std::numeric_limits<uint8>::max(),
-				std::rand() % std::numeric_limits<uint8>::max());
+#			if GLM_ARCH & GLM_ARCH_SSE2_BIT
+				__m128i s0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lane[0]));
+				__m128i s1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lane[1]));
+				__m128i s2 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lane[2]));
+				__m128i s3 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(Lane[3]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Out), _mm_add_epi32(s0, s3));
+				__m128i const t = _mm_slli_epi32(s1, 9);
+				s2 = _mm_xor_si128(s2, s0);
+				s3 = _mm_xor_si128(s3, s1);
+				s1 = _mm_xor_si128(s1, s2);
+				s0 = _mm_xor_si128(s0, s3);
+				s2 = _mm_xor_si128(s2, t);
+				s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Lane[0]), s0);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Lane[1]), s1);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Lane[2]), s2);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Lane[3]), s3);
+#			else
+				for(length_t i = 0; i < 4; ++i)
+				{
+					Out[i] = Lane[0][i] + Lane[3][i];
+					uint32 const t = Lane[1][i] << 9;
+					Lane[2][i] ^= Lane[0][i];
+					Lane[3][i] ^= Lane[1][i];
+					Lane[1][i] ^= Lane[2][i];
+					Lane[0][i] ^= Lane[3][i];
+					Lane[2][i] ^= t;
+					Lane[3][i] = rotl(Lane[3][i], 11);
+				}
+#			endif
 		}
 	};
 
-	template <qualifier P>
-	struct compute_rand<3, uint8, P>
+	GLM_FUNC_QUALIFIER rand_state& thread_rand_state()
 	{
-		GLM_FUNC_QUALIFIER static vec<3, uint8, P> call()
+#		if GLM_LANG & GLM_LANG_CXX11_FLAG
+			static thread_local rand_state State;
+#		else
+			static rand_state State;
+#		endif
+		return State;
+	}
+
+	// Uniform values in [0, 1) drawn four words at a time from the lane engine
+	template<typename T>
+	struct rand_stream
+	{
+		uint32 Bits[4];
+		length_t Next;
+
+		GLM_FUNC_QUALIFIER rand_stream() : Next(4) {}
+
+		GLM_FUNC_QUALIFIER uint32 word()
 		{
-			return vec<3, uint8, P>(
-				std::rand() % std::numeric_limits<uint8>::max(),
-				std::rand() % std::numeric_limits<uint8>::max(),
-				std::rand() % std::numeric_limits<uint8>::max());
+			if(Next == 4)
+			{
+				thread_rand_state().next4(Bits);
+				Next = 0;
+			}
+			return Bits[Next++];
 		}
+
+		GLM_FUNC_QUALIFIER T operator()();
 	};
 
-	template <qualifier P>
-	struct compute_rand<4, uint8, P>
+	template<>
+	GLM_FUNC_QUALIFIER float rand_stream<float>::operator()()
+	{
+		return static_cast<float>(word() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	template<>
+	GLM_FUNC_QUALIFIER double rand_stream<double>::operator()()
 	{
-		GLM_FUNC_QUALIFIER static vec<4, uint8, P> call()
+		uint64 const Hi = static_cast<uint64>(word() >> 6);
+		uint64 const Lo = static_cast<uint64>(word() >> 5);
+		return static_cast<double>((Hi << 27) | Lo) * (1.0 / 9007199254740992.0);
+	}
+
+	template <length_t L, typename T, qualifier Q>
+	struct compute_rand
+	{
+		GLM_FUNC_QUALIFIER static vec<L, T, Q> call();
+	};
+
+	template <length_t L, qualifier Q>
+	struct compute_rand<L, uint32, Q>
+	{
+		GLM_FUNC_QUALIFIER static vec<L, uint32, Q> call()
 		{
-			return vec<4, uint8, P>(
-				std::rand() % std::numeric_limits<uint8>::max(),
-				std::rand() % std::numeric_limits<uint8>::max(),
-				std::rand() % std::numeric_limits<uint8>::max(),
-				std::rand() % std::numeric_limits<uint8>::max());
+			vec<L, uint32, Q> Result;
+			for(length_t i = 0; i < L; ++i)
+				Result[i] = thread_rand_state().next();
+			return Result;
 		}
 	};
 
 	template <length_t L, qualifier Q>
-	struct compute_rand<L, uint16, Q>
+	struct compute_rand<L, uint8, Q>
 	{
-		GLM_FUNC_QUALIFIER static vec<L, uint16, Q> call()
+		GLM_FUNC_QUALIFIER static vec<L, uint8, Q> call()
 		{
-			return
-				(vec<L, uint16, Q>(compute_rand<L, uint8, Q>::call()) << static_cast<uint16>(8)) |
-				(vec<L, uint16, Q>(compute_rand<L, uint8, Q>::call()) << static_cast<uint16>(0));
+			return vec<L, uint8, Q>(compute_rand<L, uint32, Q>::call() >> static_cast<uint32>(24));
 		}
 	};
 
 	template <length_t L, qualifier Q>
-	struct compute_rand<L, uint32, Q>
+	struct compute_rand<L, uint16, Q>
 	{
-		GLM_FUNC_QUALIFIER static vec<L, uint32, Q> call()
+		GLM_FUNC_QUALIFIER static vec<L, uint16, Q> call()
 		{
-			return
-				(vec<L, uint32, Q>(compute_rand<L, uint16, Q>::call()) << static_cast<uint32>(16)) |
-				(vec<L, uint32, Q>(compute_rand<L, uint16, Q>::call()) << static_cast<uint32>(0));
+			return vec<L, uint16, Q>(compute_rand<L, uint32, Q>::call() >> static_cast<uint32>(16));
 		}
 	};
 
@@ -300,4 +417,105 @@ namespace detail
 
 		return vec<3, T, defaultp>(x, y, z) * Radius;
 	}
+
+	GLM_FUNC_QUALIFIER void seedRand(uint64 Seed)
+	{
+		detail::thread_rand_state().seed(Seed);
+	}
+
+	template<length_t L, typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void linearRand(vec<L, T, Q>* Out, std::size_t Count, vec<L, T, Q> const& Min, vec<L, T, Q> const& Max)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<T>::is_iec559, "'linearRand' batch only accepts floating-point inputs");
+
+		detail::rand_stream<T> Unit;
+		vec<L, T, Q> const Range(Max - Min);
+		for(std::size_t i = 0; i < Count; ++i)
+		for(length_t c = 0; c < L; ++c)
+			Out[i][c] = Unit() * Range[c] + Min[c];
+	}
+
+	template<length_t L, typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void gaussRand(vec<L, T, Q>* Out, std::size_t Count, vec<L, T, Q> const& Mean, vec<L, T, Q> const& Deviation)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<T>::is_iec559, "'gaussRand' batch only accepts floating-point inputs");
+
+		// Box-Muller: every pair of uniform draws yields two normal values
+		detail::rand_stream<T> Unit;
+		T Spare(0);
+		bool HasSpare = false;
+		for(std::size_t i = 0; i < Count; ++i)
+		for(length_t c = 0; c < L; ++c)
+		{
+			T Normal(Spare);
+			if(!HasSpare)
+			{
+				T const Radius = sqrt(T(-2) * log(T(1) - Unit()));
+				T const Angle = Unit() * static_cast<T>(6.283185307179586476925286766559);
+				Normal = Radius * cos(Angle);
+				Spare = Radius * sin(Angle);
+			}
+			HasSpare = !HasSpare;
+			Out[i][c] = Normal * Deviation[c] + Mean[c];
+		}
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void circularRand(vec<2, T, Q>* Out, std::size_t Count, T Radius)
+	{
+		assert(Radius > static_cast<T>(0));
+
+		detail::rand_stream<T> Unit;
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			T const a = Unit() * static_cast<T>(6.283185307179586476925286766559);
+			Out[i] = vec<2, T, Q>(glm::cos(a), glm::sin(a)) * Radius;
+		}
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void diskRand(vec<2, T, Q>* Out, std::size_t Count, T Radius)
+	{
+		assert(Radius > static_cast<T>(0));
+
+		// Inverse transform rather than rejection so every sample costs the same
+		detail::rand_stream<T> Unit;
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			T const r = sqrt(Unit()) * Radius;
+			T const a = Unit() * static_cast<T>(6.283185307179586476925286766559);
+			Out[i] = vec<2, T, Q>(glm::cos(a), glm::sin(a)) * r;
+		}
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void sphericalRand(vec<3, T, Q>* Out, std::size_t Count, T Radius)
+	{
+		assert(Radius > static_cast<T>(0));
+
+		detail::rand_stream<T> Unit;
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			T const z = Unit() * T(2) - T(1);
+			T const a = Unit() * static_cast<T>(6.283185307179586476925286766559);
+			T const r = sqrt(max(T(1) - z * z, T(0)));
+			Out[i] = vec<3, T, Q>(r * glm::cos(a), r * glm::sin(a), z) * Radius;
+		}
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void ballRand(vec<3, T, Q>* Out, std::size_t Count, T Radius)
+	{
+		assert(Radius > static_cast<T>(0));
+
+		detail::rand_stream<T> Unit;
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			T const z = Unit() * T(2) - T(1);
+			T const a = Unit() * static_cast<T>(6.283185307179586476925286766559);
+			T const r = sqrt(max(T(1) - z * z, T(0)));
+			T const l = pow(Unit(), static_cast<T>(1) / static_cast<T>(3)) * Radius;
+			Out[i] = vec<3, T, Q>(r * glm::cos(a), r * glm::sin(a), z) * l;
+		}
+	}
 }//namespace glm
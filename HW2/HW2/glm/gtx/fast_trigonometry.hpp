@@ -13,6 +13,7 @@
 #pragma once
 
 // Dependency:
+#include <cstddef>
 #include "../gtc/constants.hpp"
 
 #if GLM_MESSAGES == GLM_ENABLE && !defined(GLM_EXT_INCLUDED)
@@ -73,6 +74,26 @@ namespace glm
 	template<typename T>
 	GLM_FUNC_DECL T fastAtan(T angle);
 
+	/// Fast sine of Count angles, Out[i] = fastSin(In[i]).
+	/// Processes 4 floats per step with SSE2 and 8 with AVX when intrinsics are enabled.
+	/// Max absolute error is below 1e-5 for angles within [-8pi, 8pi].
+	/// From GLM_GTX_fast_trigonometry extension.
+	template<typename T>
+	GLM_FUNC_DECL void fastSin(T const* In, T* Out, std::size_t Count);
+
+	/// Fast cosine of Count angles, Out[i] = fastCos(In[i]).
+	/// Processes 4 floats per step with SSE2 and 8 with AVX when intrinsics are enabled.
+	/// Max absolute error is below 1e-5 for angles within [-8pi, 8pi].
+	/// From GLM_GTX_fast_trigonometry extension.
+	template<typename T>
+	GLM_FUNC_DECL void fastCos(T const* In, T* Out, std::size_t Count);
+
+	/// Fast arc tangent of Count values, Out[i] = fastAtan(In[i]).
+	/// Same series as fastAtan, only accurate on [-1, 1] where the max absolute error is about 4e-2 at the bounds.
+	/// From GLM_GTX_fast_trigonometry extension.
+	template<typename T>
+	GLM_FUNC_DECL void fastAtan(T const* In, T* Out, std::size_t Count);
+
 	/// @}
 }//namespace glm
 
@@ -1,5 +1,11 @@
 /// @ref gtx_fast_trigonometry
 
+#include <cstddef>
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#	include "../simd/trigonometric.h"
+#endif
+
 namespace glm{
 namespace detail
 {
@@ -25,6 +31,27 @@ namespace detail
 	{
 		return detail::functor1<vec, L, T, T, Q>::call(cos_52s, x);
 	}
+
+	template<length_t L, typename T, qualifier Q, bool Aligned>
+	struct compute_fastCos_vector
+	{
+		GLM_FUNC_QUALIFIER static vec<L, T, Q> call(vec<L, T, Q> const& x);
+	};
+
+	template<length_t L, typename T, qualifier Q, bool Aligned>
+	struct compute_fastSin_vector
+	{
+		GLM_FUNC_QUALIFIER static vec<L, T, Q> call(vec<L, T, Q> const& x);
+	};
+
+	// Array kernels, specialized for float below when SIMD intrinsics are enabled
+	template<typename T>
+	struct compute_fast_trigonometry_array
+	{
+		GLM_FUNC_QUALIFIER static void sin(T const* In, T* Out, std::size_t Count, std::size_t First);
+		GLM_FUNC_QUALIFIER static void cos(T const* In, T* Out, std::size_t Count, std::size_t First);
+		GLM_FUNC_QUALIFIER static void atan(T const* In, T* Out, std::size_t Count, std::size_t First);
+	};
 }//namespace detail
 
 	// wrapAngle
@@ -59,7 +86,7 @@ namespace detail
 	template<length_t L, typename T, qualifier Q>
 	GLM_FUNC_QUALIFIER vec<L, T, Q> fastCos(vec<L, T, Q> const& x)
 	{
-		return detail::functor1<vec, L, T, T, Q>::call(fastCos, x);
+		return detail::compute_fastCos_vector<L, T, Q, detail::is_aligned<Q>::value>::call(x);
 	}
 
 	// sin
@@ -72,7 +99,7 @@ namespace detail
 	template<length_t L, typename T, qualifier Q>
 	GLM_FUNC_QUALIFIER vec<L, T, Q> fastSin(vec<L, T, Q> const& x)
 	{
-		return detail::functor1<vec, L, T, T, Q>::call(fastSin, x);
+		return detail::compute_fastSin_vector<L, T, Q, detail::is_aligned<Q>::value>::call(x);
 	}
 
 	// tan
@@ -139,4 +166,123 @@ namespace detail
 	{
 		return detail::functor1<vec, L, T, T, Q>::call(fastAtan, x);
 	}
+namespace detail
+{
+	template<length_t L, typename T, qualifier Q, bool Aligned>
+	GLM_FUNC_QUALIFIER vec<L, T, Q> compute_fastCos_vector<L, T, Q, Aligned>::call(vec<L, T, Q> const& x)
+	{
+		return detail::functor1<vec, L, T, T, Q>::call(fastCos, x);
+	}
+
+	template<length_t L, typename T, qualifier Q, bool Aligned>
+	GLM_FUNC_QUALIFIER vec<L, T, Q> compute_fastSin_vector<L, T, Q, Aligned>::call(vec<L, T, Q> const& x)
+	{
+		return detail::functor1<vec, L, T, T, Q>::call(fastSin, x);
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void compute_fast_trigonometry_array<T>::sin(T const* In, T* Out, std::size_t Count, std::size_t First)
+	{
+		for(std::size_t i = First; i < Count; ++i)
+			Out[i] = fastSin(In[i]);
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void compute_fast_trigonometry_array<T>::cos(T const* In, T* Out, std::size_t Count, std::size_t First)
+	{
+		for(std::size_t i = First; i < Count; ++i)
+			Out[i] = fastCos(In[i]);
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void compute_fast_trigonometry_array<T>::atan(T const* In, T* Out, std::size_t Count, std::size_t First)
+	{
+		for(std::size_t i = First; i < Count; ++i)
+			Out[i] = fastAtan(In[i]);
+	}
+
+#	if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	template<qualifier Q>
+	struct compute_fastCos_vector<4, float, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static vec<4, float, Q> call(vec<4, float, Q> const& x)
+		{
+			vec<4, float, Q> Result;
+			Result.data = glm_vec4_fast_cos(x.data);
+			return Result;
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_fastSin_vector<4, float, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static vec<4, float, Q> call(vec<4, float, Q> const& x)
+		{
+			vec<4, float, Q> Result;
+			Result.data = glm_vec4_fast_sin(x.data);
+			return Result;
+		}
+	};
+
+	template<>
+	GLM_FUNC_QUALIFIER void compute_fast_trigonometry_array<float>::sin(float const* In, float* Out, std::size_t Count, std::size_t First)
+	{
+		std::size_t i = First;
+#		if GLM_ARCH & GLM_ARCH_AVX_BIT
+			for(; i + 8 <= Count; i += 8)
+				_mm256_storeu_ps(Out + i, glm_vec8_fast_sin(_mm256_loadu_ps(In + i)));
+#		endif
+		for(; i + 4 <= Count; i += 4)
+			_mm_storeu_ps(Out + i, glm_vec4_fast_sin(_mm_loadu_ps(In + i)));
+		for(; i < Count; ++i)
+			Out[i] = fastSin(In[i]);
+	}
+
+	template<>
+	GLM_FUNC_QUALIFIER void compute_fast_trigonometry_array<float>::cos(float const* In, float* Out, std::size_t Count, std::size_t First)
+	{
+		std::size_t i = First;
+#		if GLM_ARCH & GLM_ARCH_AVX_BIT
+			for(; i + 8 <= Count; i += 8)
+				_mm256_storeu_ps(Out + i, glm_vec8_fast_cos(_mm256_loadu_ps(In + i)));
+#		endif
+		for(; i + 4 <= Count; i += 4)
+			_mm_storeu_ps(Out + i, glm_vec4_fast_cos(_mm_loadu_ps(In + i)));
+		for(; i < Count; ++i)
+			Out[i] = fastCos(In[i]);
+	}
+
+	template<>
+	GLM_FUNC_QUALIFIER void compute_fast_trigonometry_array<float>::atan(float const* In, float* Out, std::size_t Count, std::size_t First)
+	{
+		std::size_t i = First;
+#		if GLM_ARCH & GLM_ARCH_AVX_BIT
+			for(; i + 8 <= Count; i += 8)
+				_mm256_storeu_ps(Out + i, glm_vec8_fast_atan(_mm256_loadu_ps(In + i)));
+#		endif
+		for(; i + 4 <= Count; i += 4)
+			_mm_storeu_ps(Out + i, glm_vec4_fast_atan(_mm_loadu_ps(In + i)));
+		for(; i < Count; ++i)
+			Out[i] = fastAtan(In[i]);
+	}
+#	endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
+}//namespace detail
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void fastSin(T const* In, T* Out, std::size_t Count)
+	{
+		detail::compute_fast_trigonometry_array<T>::sin(In, Out, Count, 0);
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void fastCos(T const* In, T* Out, std::size_t Count)
+	{
+		detail::compute_fast_trigonometry_array<T>::cos(In, Out, Count, 0);
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void fastAtan(T const* In, T* Out, std::size_t Count)
+	{
+		detail::compute_fast_trigonometry_array<T>::atan(In, Out, Count, 0);
+	}
 }//namespace glm
@@ -15,6 +15,7 @@
 
 // Dependency:
 #include <cfloat>
+#include <cstddef>
 #include <limits>
 #include "../glm.hpp"
 #include "../geometric.hpp"
@@ -86,6 +87,64 @@ namespace glm
 		genType & intersectionPosition1, genType & intersectionNormal1,
 		genType & intersectionPosition2 = genType(), genType & intersectionNormal2 = genType());
 
+	//! Compute the intersection of one ray with count planes.
+	//! Misses are written as infinity. Returns the number of hits.
+	//! From GLM_GTX_intersect extension.
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL std::size_t intersectRayPlanes(
+		vec<3, T, Q> const& orig, vec<3, T, Q> const& dir,
+		vec<3, T, Q> const* planeOrigs, vec<3, T, Q> const* planeNormals, std::size_t count,
+		T* intersectionDistances);
+
+	//! Compute the intersection of one ray with count triangles given as three vertex arrays.
+	//! Misses are written as infinity. Returns the number of hits.
+	//! From GLM_GTX_intersect extension.
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL std::size_t intersectRayTriangles(
+		vec<3, T, Q> const& orig, vec<3, T, Q> const& dir,
+		vec<3, T, Q> const* vert0, vec<3, T, Q> const* vert1, vec<3, T, Q> const* vert2, std::size_t count,
+		vec<2, T, Q>* baryPositions, T* distances);
+
+	//! Compute the intersection distances of one ray with count spheres.
+	//! The ray direction vector is unit length. Misses are written as infinity.
+	//! Four spheres are tested per step when SSE2 intrinsics are enabled. Returns the number of hits.
+	//! From GLM_GTX_intersect extension.
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL std::size_t intersectRaySpheres(
+		vec<3, T, Q> const& rayStarting, vec<3, T, Q> const& rayNormalizedDirection,
+		vec<3, T, Q> const* sphereCenters, T const* sphereRadiusSquared, std::size_t count,
+		T* intersectionDistances);
+
+	//! Compute the intersection distances of count rays with one sphere.
+	//! The ray direction vectors are unit length. Misses are written as infinity. Returns the number of hits.
+	//! From GLM_GTX_intersect extension.
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL std::size_t intersectRaysSphere(
+		vec<3, T, Q> const* rayStartings, vec<3, T, Q> const* rayNormalizedDirections, std::size_t count,
+		vec<3, T, Q> const& sphereCenter, T const sphereRadiusSquared,
+		T* intersectionDistances);
+
+	//! Compute the first time in [0, 1] at which the segment orig + t * displacement enters a 2D box.
+	//! intersectionNormal is the normal of the box face that was crossed.
+	//! Returns false if the segment misses the box or starts inside it.
+	//! From GLM_GTX_intersect extension.
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL bool intersectSegmentAABB(
+		vec<2, T, Q> const& orig, vec<2, T, Q> const& displacement,
+		vec<2, T, Q> const& boxMin, vec<2, T, Q> const& boxMax,
+		T & intersectionTime, vec<2, T, Q> & intersectionNormal);
+
+	//! Continuous collision of a moving 2D box against a static one.
+	//! Compute the first time in [0, 1] of the move at which the boxes touch and the obstacle face normal.
+	//! Grazing a face or corner counts as touching. Returns false if the boxes already overlap
+	//! at the start or the displacement is zero, leaving the outputs unchanged.
+	//! From GLM_GTX_intersect extension.
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL bool intersectSweptAABB(
+		vec<2, T, Q> const& center, vec<2, T, Q> const& halfExtents, vec<2, T, Q> const& displacement,
+		vec<2, T, Q> const& obstacleCenter, vec<2, T, Q> const& obstacleHalfExtents,
+		T & intersectionTime, vec<2, T, Q> & intersectionNormal);
+
 	/// @}
 }//namespace glm
 
@@ -194,4 +194,260 @@ namespace glm
 		intersectionNormal2 = (intersectionPoint2 - sphereCenter) / sphereRadius;
 		return true;
 	}
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER std::size_t intersectRayPlanes
+	(
+		vec<3, T, Q> const& orig, vec<3, T, Q> const& dir,
+		vec<3, T, Q> const* planeOrigs, vec<3, T, Q> const* planeNormals, std::size_t count,
+		T* intersectionDistances
+	)
+	{
+		T const Epsilon = std::numeric_limits<T>::epsilon();
+		T const Miss = std::numeric_limits<T>::infinity();
+
+		std::size_t Hits = 0;
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			T const d = glm::dot(dir, planeNormals[i]);
+			bool const Hit = d < -Epsilon;
+			intersectionDistances[i] = Hit ? glm::dot(planeOrigs[i] - orig, planeNormals[i]) / d : Miss;
+			Hits += Hit ? 1 : 0;
+		}
+		return Hits;
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER std::size_t intersectRayTriangles
+	(
+		vec<3, T, Q> const& orig, vec<3, T, Q> const& dir,
+		vec<3, T, Q> const* vert0, vec<3, T, Q> const* vert1, vec<3, T, Q> const* vert2, std::size_t count,
+		vec<2, T, Q>* baryPositions, T* distances
+	)
+	{
+		T const Epsilon = std::numeric_limits<T>::epsilon();
+		T const Miss = std::numeric_limits<T>::infinity();
+
+		// Same tests as intersectRayTriangle, reordered so the loop body has no early exit
+		std::size_t Hits = 0;
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			vec<3, T, Q> const edge1 = vert1[i] - vert0[i];
+			vec<3, T, Q> const edge2 = vert2[i] - vert0[i];
+			vec<3, T, Q> const p = glm::cross(dir, edge2);
+			T const det = glm::dot(edge1, p);
+			T const inv_det = abs(det) > Epsilon ? static_cast<T>(1) / det : static_cast<T>(0);
+
+			vec<3, T, Q> const dist = orig - vert0[i];
+			vec<3, T, Q> const q = glm::cross(dist, edge1);
+			T const a = glm::dot(dist, p);
+			T const b = glm::dot(dir, q);
+
+			// bounds tested before dividing by det, as intersectRayTriangle does, so
+			// rays through an edge hit or miss the same; negating for a back face is exact
+			T const s = det < static_cast<T>(0) ? static_cast<T>(-1) : static_cast<T>(1);
+			bool const Hit = inv_det != static_cast<T>(0) &&
+				a * s >= static_cast<T>(0) && a * s <= det * s &&
+				b * s >= static_cast<T>(0) && (a + b) * s <= det * s;
+			baryPositions[i] = vec<2, T, Q>(a * inv_det, b * inv_det);
+			distances[i] = Hit ? glm::dot(edge2, q) * inv_det : Miss;
+			Hits += Hit ? 1 : 0;
+		}
+		return Hits;
+	}
+
+namespace detail
+{
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER std::size_t intersectRaySpheres_scalar
+	(
+		vec<3, T, Q> const& rayStarting, vec<3, T, Q> const& rayNormalizedDirection,
+		vec<3, T, Q> const* sphereCenters, T const* sphereRadiusSquared, std::size_t first, std::size_t count,
+		T* intersectionDistances
+	)
+	{
+		T const Epsilon = std::numeric_limits<T>::epsilon();
+		T const Miss = std::numeric_limits<T>::infinity();
+
+		std::size_t Hits = 0;
+		for(std::size_t i = first; i < count; ++i)
+		{
+			vec<3, T, Q> const diff = sphereCenters[i] - rayStarting;
+			T const t0 = dot(diff, rayNormalizedDirection);
+			T const dSquared = dot(diff, diff) - t0 * t0;
+			T const t1 = sqrt(max(sphereRadiusSquared[i] - dSquared, static_cast<T>(0)));
+			T const Distance = t0 > t1 + Epsilon ? t0 - t1 : t0 + t1;
+			bool const Hit = dSquared <= sphereRadiusSquared[i] && Distance > Epsilon;
+			intersectionDistances[i] = Hit ? Distance : Miss;
+			Hits += Hit ? 1 : 0;
+		}
+		return Hits;
+	}
+
+	template<typename T, qualifier Q>
+	struct compute_intersectRaySpheres
+	{
+		GLM_FUNC_QUALIFIER static std::size_t call
+		(
+			vec<3, T, Q> const& rayStarting, vec<3, T, Q> const& rayNormalizedDirection,
+			vec<3, T, Q> const* sphereCenters, T const* sphereRadiusSquared, std::size_t count,
+			T* intersectionDistances
+		)
+		{
+			return intersectRaySpheres_scalar(rayStarting, rayNormalizedDirection,
+				sphereCenters, sphereRadiusSquared, 0, count, intersectionDistances);
+		}
+	};
+
+#	if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	template<qualifier Q>
+	struct compute_intersectRaySpheres<float, Q>
+	{
+		GLM_FUNC_QUALIFIER static std::size_t call
+		(
+			vec<3, float, Q> const& rayStarting, vec<3, float, Q> const& rayNormalizedDirection,
+			vec<3, float, Q> const* sphereCenters, float const* sphereRadiusSquared, std::size_t count,
+			float* intersectionDistances
+		)
+		{
+			glm_vec4 const Epsilon = _mm_set1_ps(std::numeric_limits<float>::epsilon());
+			glm_vec4 const Miss = _mm_set1_ps(std::numeric_limits<float>::infinity());
+			glm_vec4 const Ox = _mm_set1_ps(rayStarting.x);
+			glm_vec4 const Oy = _mm_set1_ps(rayStarting.y);
+			glm_vec4 const Oz = _mm_set1_ps(rayStarting.z);
+			glm_vec4 const Dx = _mm_set1_ps(rayNormalizedDirection.x);
+			glm_vec4 const Dy = _mm_set1_ps(rayNormalizedDirection.y);
+			glm_vec4 const Dz = _mm_set1_ps(rayNormalizedDirection.z);
+
+			std::size_t Hits = 0;
+			std::size_t i = 0;
+			for(; i + 4 <= count; i += 4)
+			{
+				vec<3, float, Q> const* c = sphereCenters + i;
+				glm_vec4 const Fx = _mm_sub_ps(_mm_setr_ps(c[0].x, c[1].x, c[2].x, c[3].x), Ox);
+				glm_vec4 const Fy = _mm_sub_ps(_mm_setr_ps(c[0].y, c[1].y, c[2].y, c[3].y), Oy);
+				glm_vec4 const Fz = _mm_sub_ps(_mm_setr_ps(c[0].z, c[1].z, c[2].z, c[3].z), Oz);
+				glm_vec4 const R2 = _mm_loadu_ps(sphereRadiusSquared + i);
+
+				glm_vec4 const t0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Fx, Dx), _mm_mul_ps(Fy, Dy)), _mm_mul_ps(Fz, Dz));
+				glm_vec4 const ff = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Fx, Fx), _mm_mul_ps(Fy, Fy)), _mm_mul_ps(Fz, Fz));
+				glm_vec4 const dSquared = _mm_sub_ps(ff, _mm_mul_ps(t0, t0));
+				glm_vec4 const t1 = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(R2, dSquared), _mm_setzero_ps()));
+
+				glm_vec4 const Near = _mm_cmpgt_ps(t0, _mm_add_ps(t1, Epsilon));
+				glm_vec4 const Distance = _mm_or_ps(
+					_mm_and_ps(Near, _mm_sub_ps(t0, t1)),
+					_mm_andnot_ps(Near, _mm_add_ps(t0, t1)));
+				glm_vec4 const Hit = _mm_and_ps(_mm_cmple_ps(dSquared, R2), _mm_cmpgt_ps(Distance, Epsilon));
+
+				_mm_storeu_ps(intersectionDistances + i, _mm_or_ps(_mm_and_ps(Hit, Distance), _mm_andnot_ps(Hit, Miss)));
+
+				int const Mask = _mm_movemask_ps(Hit);
+				Hits += static_cast<std::size_t>((Mask & 1) + ((Mask >> 1) & 1) + ((Mask >> 2) & 1) + ((Mask >> 3) & 1));
+			}
+
+			return Hits + intersectRaySpheres_scalar(rayStarting, rayNormalizedDirection,
+				sphereCenters, sphereRadiusSquared, i, count, intersectionDistances);
+		}
+	};
+#	endif
+}//namespace detail
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER std::size_t intersectRaySpheres
+	(
+		vec<3, T, Q> const& rayStarting, vec<3, T, Q> const& rayNormalizedDirection,
+		vec<3, T, Q> const* sphereCenters, T const* sphereRadiusSquared, std::size_t count,
+		T* intersectionDistances
+	)
+	{
+		return detail::compute_intersectRaySpheres<T, Q>::call(
+			rayStarting, rayNormalizedDirection, sphereCenters, sphereRadiusSquared, count, intersectionDistances);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER std::size_t intersectRaysSphere
+	(
+		vec<3, T, Q> const* rayStartings, vec<3, T, Q> const* rayNormalizedDirections, std::size_t count,
+		vec<3, T, Q> const& sphereCenter, T const sphereRadiusSquared,
+		T* intersectionDistances
+	)
+	{
+		T const Epsilon = std::numeric_limits<T>::epsilon();
+		T const Miss = std::numeric_limits<T>::infinity();
+
+		std::size_t Hits = 0;
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			vec<3, T, Q> const diff = sphereCenter - rayStartings[i];
+			T const t0 = dot(diff, rayNormalizedDirections[i]);
+			T const dSquared = dot(diff, diff) - t0 * t0;
+			T const t1 = sqrt(max(sphereRadiusSquared - dSquared, static_cast<T>(0)));
+			T const Distance = t0 > t1 + Epsilon ? t0 - t1 : t0 + t1;
+			bool const Hit = dSquared <= sphereRadiusSquared && Distance > Epsilon;
+			intersectionDistances[i] = Hit ? Distance : Miss;
+			Hits += Hit ? 1 : 0;
+		}
+		return Hits;
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER bool intersectSegmentAABB
+	(
+		vec<2, T, Q> const& orig, vec<2, T, Q> const& displacement,
+		vec<2, T, Q> const& boxMin, vec<2, T, Q> const& boxMax,
+		T & intersectionTime, vec<2, T, Q> & intersectionNormal
+	)
+	{
+		T const Epsilon = std::numeric_limits<T>::epsilon();
+
+		// slab test: entry is the latest of the per-axis entries, exit the earliest exit
+		T Entry = -std::numeric_limits<T>::infinity();
+		T Exit = std::numeric_limits<T>::infinity();
+		vec<2, T, Q> Normal(0);
+
+		for(length_t i = 0; i < 2; ++i)
+		{
+			if(abs(displacement[i]) < Epsilon)
+			{
+				if(orig[i] < boxMin[i] || orig[i] > boxMax[i])
+					return false;
+				continue;
+			}
+
+			T const InvDisplacement = static_cast<T>(1) / displacement[i];
+			T const Near = ((displacement[i] > static_cast<T>(0) ? boxMin[i] : boxMax[i]) - orig[i]) * InvDisplacement;
+			T const Far = ((displacement[i] > static_cast<T>(0) ? boxMax[i] : boxMin[i]) - orig[i]) * InvDisplacement;
+
+			if(Near > Entry)
+			{
+				Entry = Near;
+				Normal = vec<2, T, Q>(0);
+				Normal[i] = displacement[i] > static_cast<T>(0) ? static_cast<T>(-1) : static_cast<T>(1);
+			}
+			Exit = min(Exit, Far);
+		}
+
+		// starting inside the box or missing it within this step are both reported as no hit
+		if(Entry > Exit || Entry < static_cast<T>(0) || Entry > static_cast<T>(1))
+			return false;
+
+		intersectionTime = Entry;
+		intersectionNormal = Normal;
+		return true;
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER bool intersectSweptAABB
+	(
+		vec<2, T, Q> const& center, vec<2, T, Q> const& halfExtents, vec<2, T, Q> const& displacement,
+		vec<2, T, Q> const& obstacleCenter, vec<2, T, Q> const& obstacleHalfExtents,
+		T & intersectionTime, vec<2, T, Q> & intersectionNormal
+	)
+	{
+		// Minkowski sum: sweeping the box is the same as sweeping its center against the grown obstacle
+		vec<2, T, Q> const Extents = halfExtents + obstacleHalfExtents;
+		return intersectSegmentAABB(center, displacement,
+			obstacleCenter - Extents, obstacleCenter + Extents,
+			intersectionTime, intersectionNormal);
+	}
 }//namespace glm
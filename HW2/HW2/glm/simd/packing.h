@@ -3,6 +3,45 @@
 
 #pragma once
 
+#include "platform.h"
+
+// F16C ships with every AVX2 CPU; MSVC has no __F16C__ macro so infer it from /arch:AVX2
+#if (GLM_ARCH & GLM_ARCH_SSE2_BIT) && (defined(__F16C__) || ((GLM_COMPILER & GLM_COMPILER_VC) && (GLM_ARCH & GLM_ARCH_AVX2_BIT)))
+#	define GLM_SIMD_HAS_F16C 1
+#	include <immintrin.h>
+#else
+#	define GLM_SIMD_HAS_F16C 0
+#endif
+
 #if GLM_ARCH & GLM_ARCH_SSE2_BIT
 
+// Clamp floats to [0, 1] and scale them to [0, 255] rounding halves away from
+// zero, like packUnorm1x8. Truncates then rounds up when the exact remainder
+// is at least a half; adding 0.5 first would round 0.49999997 up.
+GLM_FUNC_QUALIFIER glm_ivec4 glm_vec4_unorm8_round(glm_vec4 v)
+{
+	glm_vec4 const x = _mm_mul_ps(_mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f)), _mm_set1_ps(255.0f));
+	glm_ivec4 const t = _mm_cvttps_epi32(x);
+	glm_vec4 const up = _mm_cmpge_ps(_mm_sub_ps(x, _mm_cvtepi32_ps(t)), _mm_set1_ps(0.5f));
+	return _mm_sub_epi32(t, _mm_castps_si128(up)); // the mask is -1 where rounding up
+}
+
+// Clamp four registers of floats to [0, 1] and pack them into 16 unsigned bytes, same as packUnorm1x8 each
+GLM_FUNC_QUALIFIER glm_uvec4 glm_vec4_pack_unorm8x16(glm_vec4 a, glm_vec4 b, glm_vec4 c, glm_vec4 d)
+{
+	glm_ivec4 const ia = glm_vec4_unorm8_round(a);
+	glm_ivec4 const ib = glm_vec4_unorm8_round(b);
+	glm_ivec4 const ic = glm_vec4_unorm8_round(c);
+	glm_ivec4 const id = glm_vec4_unorm8_round(d);
+	return _mm_packus_epi16(_mm_packs_epi32(ia, ib), _mm_packs_epi32(ic, id));
+}
+
+// Expand the low four unsigned bytes of v to normalized floats
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_unpack_unorm8x4(glm_uvec4 v)
+{
+	glm_ivec4 const zro0 = _mm_setzero_si128();
+	glm_ivec4 const i32 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zro0), zro0);
+	return _mm_mul_ps(_mm_cvtepi32_ps(i32), _mm_set1_ps(1.0f / 255.0f));
+}
+
 #endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
@@ -3,7 +3,82 @@
 
 #pragma once
 
+#include "common.h"
+
 #if GLM_ARCH & GLM_ARCH_SSE2_BIT
 
+// Same cos_52s minimax polynomial as GLM_GTX_fast_trigonometry, with the
+// quadrant branches replaced by masks. Max absolute error is below 1e-5
+// for angles within [-8pi, 8pi], range reduction error grows past that.
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_fast_cos(glm_vec4 x)
+{
+	// range reduction to [-pi, pi] then fold to [0, pi]
+	glm_vec4 const k = glm_vec4_round(glm_vec4_mul(x, _mm_set1_ps(0.15915494309189533577f)));
+	glm_vec4 const r = glm_vec4_sub(x, glm_vec4_mul(k, _mm_set1_ps(6.28318530717958647692f)));
+	glm_vec4 const a = glm_vec4_abs(r);
+
+	// cos(a) = -cos(pi - a) on [pi/2, pi]
+	glm_vec4 const m = _mm_min_ps(a, glm_vec4_sub(_mm_set1_ps(3.14159265358979323846f), a));
+	glm_vec4 const neg = _mm_and_ps(_mm_cmpgt_ps(a, _mm_set1_ps(1.57079632679489661923f)), _mm_set1_ps(-0.0f));
+
+	glm_vec4 const xx = glm_vec4_mul(m, m);
+	glm_vec4 p = glm_vec4_add(_mm_set1_ps(0.0414877472f), glm_vec4_mul(xx, _mm_set1_ps(-0.0012712095f)));
+	p = glm_vec4_add(_mm_set1_ps(-0.4999124376f), glm_vec4_mul(xx, p));
+	p = glm_vec4_add(_mm_set1_ps(0.9999932946f), glm_vec4_mul(xx, p));
+	return _mm_xor_ps(p, neg);
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_fast_sin(glm_vec4 x)
+{
+	return glm_vec4_fast_cos(glm_vec4_sub(_mm_set1_ps(1.57079632679489661923f), x));
+}
+
+// Taylor series of GLM_GTX_fast_trigonometry fastAtan, only accurate on [-1, 1]
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_fast_atan(glm_vec4 x)
+{
+	glm_vec4 const xx = glm_vec4_mul(x, x);
+	glm_vec4 p = glm_vec4_add(_mm_set1_ps(0.111111111111f), glm_vec4_mul(xx, _mm_set1_ps(-0.0909090909f)));
+	p = glm_vec4_add(_mm_set1_ps(-0.1428571429f), glm_vec4_mul(xx, p));
+	p = glm_vec4_add(_mm_set1_ps(0.2f), glm_vec4_mul(xx, p));
+	p = glm_vec4_add(_mm_set1_ps(-0.333333333333f), glm_vec4_mul(xx, p));
+	p = glm_vec4_add(_mm_set1_ps(1.0f), glm_vec4_mul(xx, p));
+	return glm_vec4_mul(x, p);
+}
+
 #endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
 
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+
+GLM_FUNC_QUALIFIER __m256 glm_vec8_fast_cos(__m256 x)
+{
+	__m256 const k = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(0.15915494309189533577f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256 const r = _mm256_sub_ps(x, _mm256_mul_ps(k, _mm256_set1_ps(6.28318530717958647692f)));
+	__m256 const a = _mm256_and_ps(r, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)));
+
+	__m256 const m = _mm256_min_ps(a, _mm256_sub_ps(_mm256_set1_ps(3.14159265358979323846f), a));
+	__m256 const neg = _mm256_and_ps(_mm256_cmp_ps(a, _mm256_set1_ps(1.57079632679489661923f), _CMP_GT_OQ), _mm256_set1_ps(-0.0f));
+
+	__m256 const xx = _mm256_mul_ps(m, m);
+	__m256 p = _mm256_add_ps(_mm256_set1_ps(0.0414877472f), _mm256_mul_ps(xx, _mm256_set1_ps(-0.0012712095f)));
+	p = _mm256_add_ps(_mm256_set1_ps(-0.4999124376f), _mm256_mul_ps(xx, p));
+	p = _mm256_add_ps(_mm256_set1_ps(0.9999932946f), _mm256_mul_ps(xx, p));
+	return _mm256_xor_ps(p, neg);
+}
+
+GLM_FUNC_QUALIFIER __m256 glm_vec8_fast_sin(__m256 x)
+{
+	return glm_vec8_fast_cos(_mm256_sub_ps(_mm256_set1_ps(1.57079632679489661923f), x));
+}
+
+GLM_FUNC_QUALIFIER __m256 glm_vec8_fast_atan(__m256 x)
+{
+	__m256 const xx = _mm256_mul_ps(x, x);
+	__m256 p = _mm256_add_ps(_mm256_set1_ps(0.111111111111f), _mm256_mul_ps(xx, _mm256_set1_ps(-0.0909090909f)));
+	p = _mm256_add_ps(_mm256_set1_ps(-0.1428571429f), _mm256_mul_ps(xx, p));
+	p = _mm256_add_ps(_mm256_set1_ps(0.2f), _mm256_mul_ps(xx, p));
+	p = _mm256_add_ps(_mm256_set1_ps(-0.333333333333f), _mm256_mul_ps(xx, p));
+	p = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(xx, p));
+	return _mm256_mul_ps(x, p);
+}
+
+#endif//GLM_ARCH & GLM_ARCH_AVX_BIT
@@ -18,9 +18,35 @@
 
 #include <SDL.h>
 #include <SDL_opengl.h>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "glm/mat4x4.hpp"                
 #include "glm/gtc/matrix_transform.hpp"  
+#include "glm/gtc/random.hpp"
 #include "ShaderProgram.h"               
+#include "Profiler.h"
+#include "GpuTimer.h"
+#include "RenderThread.h"
+#include "Simulation.h"
+#include "Replay.h"
+#include "Rollback.h"
+#include "Ai.h"
+#include "FramePacer.h"
+#include "Culling.h"
+#include "Headless.h"
+#include "StreamBuffer.h"
+#include "ShaderWatcher.h"
+#include "TextureResidency.h"
+#include "TextureBaker.h"
+#include "FrameCapture.h"
 #include "stb_image.h"
 
 #define LOG(argument) std::cout << argument << '\n'
@@ -34,9 +60,11 @@ VIEWPORT_Y = 0,
 VIEWPORT_WIDTH = WINDOW_WIDTH,
 VIEWPORT_HEIGHT = WINDOW_HEIGHT;
 
-// for time.deltaTime
-float g_previous_ticks = 0.0f;
-const float MILLISECONDS_IN_SECOND = 1000.0f;
+// fixed timestep simulation, rendering interpolates between the last two steps
+const float MAX_FRAME_TIME = 0.25f; // drop time after a long hitch instead of spiralling
+Uint64 g_previous_counter = 0;
+float g_accumulator = 0.0f;
+float g_interpolation_alpha = 0.0f;
 
 // Background color -- blood red
 const float BG_RED = 0.812f,
@@ -46,13 +74,25 @@ BG_OPACITY = 0.208f;
 
 // shaders
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-           F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+           F_SHADER_PATH[] = "shaders/fragment_textured.glsl",
+           PROGRAM_CACHE_PATH[] = "shaders/textured.program"; // linked binary, see ProgramCache.h
 
 ShaderProgram g_shader_program;
 
+// --hot-reload: recompile the shaders when they're saved, the old program
+// keeps drawing until the new one has linked
+bool g_hot_reload = false;
+ShaderWatcher g_shader_watcher;
+ShaderProgram g_reloading_shader_program;
+bool g_shader_reload_pending = false;
+
 // to display game and check if running
-bool g_game_is_running = true;
+std::atomic<bool> g_game_is_running{ true };
 SDL_Window* g_display_window;
+SDL_GLContext g_gl_context;
+
+// the render thread owns the GL context once initialise() is done
+RenderThread g_render_thread;
 
 
 glm::mat4 g_view_matrix, // position of the camera
@@ -70,118 +110,471 @@ TUMBLEWEED_SPRITE[] = "Tumbleweed.png",
 P1_WIN_SPRITE[] = "p1win.png",
 P2_WIN_SPRITE[] = "p2win.png";
 
-GLuint left_cowboy_texture_id,
+TextureHandle left_cowboy_texture_id,
 right_cowboy_texture_id,
 tumbleweed_texture_id,
 p1_win_texture_id,
 p2_win_texture_id;
 
-const int NUMBER_OF_TEXTURES = 1;
-const GLint LEVEL_OF_DETAIL = 0,
-			TEXTURE_BORDER = 0;
-
-// position and movement matrixes
-// offset x position to get them in starting points
-float offset = 4.3f;
-glm::vec3 left_cowboy_position = glm::vec3(0, 0, 0),
-left_cowboy_movement = glm::vec3(0, 0, 0),
-right_cowboy_position = glm::vec3(0, 0, 0),
-right_cowboy_movement = glm::vec3(0, 0, 0),
-tumbleweed_position = glm::vec3(0, 0, 0),
-tumbleweed_movement = glm::vec3(0, 0, 0);
-
-// scale matrixes
-const glm::vec3 cowboy_scale = glm::vec3(1.0f, 1.0f, 0.0f),
-tumbleweed_scale = glm::vec3(0.5f, 0.5f, 0.0f);
-glm::vec3 p1_win_scale = glm::vec3(0.0f, 0.0f, 0.0f),
-p2_win_scale = glm::vec3(0.0f, 0.0f, 0.0f);
-
-const float COWBOY_MOVEMENT_SPEED = 3.0f;
-const float TUMBLEWEED_SPEED = 4.0f;
-const float WALL_BORDER = 3.0f;
-
-bool game_ended = false;
-bool singleplayer = false;
+// images are decoded on a worker thread and uploaded by whichever thread has the context
+TextureUploader g_texture_uploader;
+
+// --bake <image>...: compress images to .ktx files that load_texture uses instead
+// --bake-format <bc|etc2>: BC1/BC3 for desktop GPUs (the default) or ETC2
+std::vector<const char*> g_bake_paths;
+TextureBakeTarget g_bake_target = BAKE_BC;
+
+// --texture-budget <MB>: GPU memory for textures, the least recently drawn are freed beyond it
+TextureResidency g_textures;
+size_t g_texture_budget_mb = 64;
+
+// current and previous fixed step, rendering interpolates between them
+GameState g_state,
+g_previous_state;
+
+// The main thread only collects input: it waits on SDL events and queues each
+// key change with the time it arrived. The game thread applies every change
+// at the tick its timestamp falls in, instead of once per frame.
+enum InputEventType
+{
+    INPUT_EVENT_PRESS,
+    INPUT_EVENT_RELEASE,
+    INPUT_EVENT_TOGGLE_SINGLEPLAYER
+};
+
+struct InputEvent
+{
+    uint64_t time_ns;
+    uint8_t type;
+    uint8_t input_bit;
+};
+
+const int INPUT_WAIT_MS = 5;
+uint64_t g_last_input_time_ns = 0; // keeps the queue in time order, see input_event_time_ns
+SpscQueue<InputEvent, 256> g_input_events;
+
+// game thread's view of the keyboard
+uint8_t g_held_input = 0;
+bool singleplayer = false; // the AI plays the right cowboy
+
+// win screens, shown once someone wins
+const glm::vec3 win_scale = glm::vec3(10.0f, 8.0f, 8.0f);
+
+// --record <file>: log every tick's input to replay the match later
+// --replay <file>...: re-simulate recorded matches headlessly and check their final states
+const char* g_record_output_path = NULL;
+Replay g_recording;
+std::vector<const char*> g_replay_paths;
+
+// --ai-bench <matches> <seconds>: AI against AI in many headless matches at once
+int g_ai_bench_matches = 0;
+float g_ai_bench_seconds = 0.0f;
+const glm::uint64 AI_BENCH_SEED = 1; // the same serves every run, so runs compare
+
+// --loopback <latency_ms> <loss>: plays the two cowboys through rollback sessions
+// connected by a simulated link, the window shows the left player's session;
+// the link's drops and jitter are drawn on the game thread from a fixed seed
+const glm::uint64 LOOPBACK_SEED = 2;
+bool g_netplay = false;
+float g_loopback_latency_ms = 0.0f,
+g_loopback_loss = 0.0f;
+LoopbackTransport g_local_transport,
+g_remote_transport;
+RollbackSession g_local_session,
+g_remote_session;
+
+// --headless <frames>: draw an AI match offscreen without a window and report frame times
+// --golden <ppm>: exit non-zero unless the last frame matches this image pixel for pixel
+// --write-golden <ppm>: save the last frame as a new golden image
+int g_headless_frames = 0;
+const char* g_golden_path = NULL;
+const char* g_write_golden_path = NULL;
+const int HEADLESS_TICKS_PER_FRAME = 4; // a 60 fps frame of 240 Hz steps
+
+// --capture <file.y4m|pattern.ppm>: record every frame drawn, see FrameCapture
+const char* g_capture_path = NULL;
+const int CAPTURE_FRAMES_PER_SECOND = 60; // what vsync and --headless draw at
+FrameCapture g_frame_capture;
+
+// --profile <file>: record CPU zones and write them as Chrome trace JSON on exit
+const char* g_profile_output_path = NULL;
+
+// --pacing <vsync|vsync-locked|adaptive|capped:<fps>|uncapped>: when frames start, see FramePacer
+// --latency: print an input to present latency histogram on exit
+FramePacer g_frame_pacer;
+uint64_t g_input_time_ns = 0; // oldest input event applied this frame, 0 if none
+bool g_measure_latency = false;
+LatencyHistogram g_latency_histogram; // written by the render thread
+
+// sprites culled before submission in the last frame, also recorded as profiler counters
+CullStats g_cull_stats;
+
+// sprites are transformed on the render thread and streamed to the GPU every frame
+struct SpriteVertex
+{
+    float x, y; // already through the model matrix
+    float u, v;
+};
+
+const int SPRITE_VERTEX_COUNT = 6; // for the two halves of an image texture
+const float SPRITE_QUAD_POSITIONS[] = {
+    -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f,  // triangle 1
+    -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f   // triangle 2
+};
+const float SPRITE_QUAD_TEXTURE_COORDINATES[] = {
+    0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,     // triangle 1
+    0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f,     // triangle 2
+};
+
+StreamBuffer g_sprite_stream;
+
+// GPU pass timings go to the profiler's GPU track, --gpu-timing also shows them in the title bar
+GpuTimer g_gpu_timer;
+bool g_show_gpu_timing = false;
+Uint32 g_gpu_timing_last_ticks = 0;
+std::mutex g_gpu_timing_mutex;
+char g_gpu_timing_text[192] = "";
+const Uint32 GPU_TIMING_REFRESH_MS = 500;
 
 // helpers
-GLuint load_texture(const char* filepath);
-void draw_object(glm::mat4& object_model_matrix, GLuint& object_texture_id);
-void normalize(glm::vec3& movement);
-void limit_to_border(glm::vec3& position, glm::vec3& movement);
-void cowboy_check(glm::vec3& tumbleweed_pos, const glm::vec3& tumbleweed_size,
-    glm::vec3& obstacle_pos, const glm::vec3& obstacle_size);
-std::pair<bool, int> wall_check(glm::vec3& tumbleweed_pos, glm::vec3& tumbleweed_move);
-void check_for_game_end();
+TextureHandle load_texture(const char* filepath);
+void draw_object(GLuint object_texture_id, int first_vertex);
+void write_sprite_vertices(SpriteVertex* vertices, const glm::mat4& model_matrix);
+void interpolate_model_matrices(float alpha);
 // for game program
+void parse_arguments(int argc, char* argv[]);
+void pace_frame();
+int run_replays();
+int run_ai_bench();
+int run_headless();
+int run_bake();
 void initialise();
+void initialise_scene();
 void process_input();
+void run_game_loop();
+void update_window_title();
+uint8_t consume_input_events(uint64_t until_ns);
 void update();
 void render();
+void build_render_frame(RenderFrame& frame);
+void submit_sprite(RenderFrame& frame, const glm::mat4& model_matrix, TextureHandle texture_id);
+void render_frame(const RenderFrame& frame);
+void reload_shaders();
 void shutdown();
 
 
 int main(int argc, char* argv[])
 {
+    parse_arguments(argc, argv);
+    if (!g_replay_paths.empty()) return run_replays();
+    if (g_ai_bench_matches > 0) return run_ai_bench();
+    if (g_headless_frames > 0) return run_headless();
+    if (!g_bake_paths.empty()) return run_bake();
+
     initialise(); // initailize all game objects and code -- runs ONCE
 
+    // SDL events have to be handled on the thread that made the window
+    std::thread game_thread(run_game_loop);
     while (g_game_is_running)
     {
         process_input(); // get input from player
-        update(); // update the game state, run every frame
-        render(); // show the game state (after update to show changes in game state)
+        update_window_title();
     }
+    // stopped first so a game thread waiting on a present can't wait forever
+    g_render_thread.stop();
+    game_thread.join();
 
     shutdown(); // close game safely
     return 0;
 }
 
-// loads a texture to be used by OpenGL
-GLuint load_texture(const char* filepath)
+void parse_arguments(int argc, char* argv[])
 {
-    // Load image file from filepath
-    int width, height, number_of_components;
-    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+        {
+            g_profile_output_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--gpu-timing") == 0)
+        {
+            g_show_gpu_timing = true;
+        }
+        else if (strcmp(argv[i], "--pacing") == 0 && i + 1 < argc)
+        {
+            if (!g_frame_pacer.parse(argv[++i])) LOG("Unknown pacing mode " << argv[i] << ", using vsync");
+        }
+        else if (strcmp(argv[i], "--hot-reload") == 0)
+        {
+            g_hot_reload = true;
+        }
+        else if (strcmp(argv[i], "--bake") == 0)
+        {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) g_bake_paths.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bake-format") == 0 && i + 1 < argc)
+        {
+            i++;
+            if (strcmp(argv[i], "etc2") == 0) g_bake_target = BAKE_ETC2;
+            else if (strcmp(argv[i], "bc") == 0) g_bake_target = BAKE_BC;
+            else LOG("Unknown bake format " << argv[i] << ", using bc");
+        }
+        else if (strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc)
+        {
+            g_texture_budget_mb = (size_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--latency") == 0)
+        {
+            g_measure_latency = true;
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            g_record_output_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0)
+        {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) g_replay_paths.push_back(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--ai-bench") == 0 && i + 2 < argc)
+        {
+            g_ai_bench_matches = atoi(argv[++i]);
+            g_ai_bench_seconds = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--loopback") == 0 && i + 2 < argc)
+        {
+            g_netplay = true;
+            g_loopback_latency_ms = (float)atof(argv[++i]);
+            g_loopback_loss = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc)
+        {
+            g_headless_frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+        {
+            g_golden_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--write-golden") == 0 && i + 1 < argc)
+        {
+            g_write_golden_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+        {
+            g_capture_path = argv[++i];
+        }
+    }
 
-    // Throw error if no image found at filepath
-    if (image == NULL)
+    if (g_netplay && g_record_output_path != NULL)
     {
-        LOG(" Unable to load image. Make sure the path is correct.");
-        assert(false);
+        LOG("--record isn't supported with --loopback, not recording");
+        g_record_output_path = NULL;
     }
 
-    // Generate and bind texture ID to image
-    GLuint textureID;
-    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+    if (g_profile_output_path != NULL)
+    {
+        profiler_set_thread_name("main");
+        profiler_set_enabled(true);
+    }
+}
 
-    // Setting up texture filter parameters
-    // NEAREST better for pixel art
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+// returns the process exit code: 0 if every replay ended in its recorded state
+int run_replays()
+{
+    int failures = 0;
+    Uint64 total_ticks = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-    // Release from memory and return texture id
-    stbi_image_free(image);
+    Replay replay;
+    GameState final_state;
+    for (const char* path : g_replay_paths)
+    {
+        if (!replay_load(path, replay))
+        {
+            LOG(path << ": unable to load replay");
+            failures++;
+            continue;
+        }
 
-    return textureID;
+        uint64_t hash = replay_simulate(replay, final_state);
+        total_ticks += replay.inputs.size();
+        if (hash != replay.final_hash)
+        {
+            LOG(path << ": MISMATCH after " << replay.inputs.size() << " ticks");
+            failures++;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG(g_replay_paths.size() - failures << "/" << g_replay_paths.size() << " replays match, "
+        << total_ticks << " ticks in " << seconds << "s");
+    return failures == 0 ? 0 : 1;
 }
 
-void check_for_game_end()
+// every match starts with a different serve so they don't all play out the same
+int run_ai_bench()
 {
-    if (tumbleweed_position.x > 11.0f)
+    size_t count = (size_t)g_ai_bench_matches;
+    std::vector<GameState> states(count);
+    glm::seedRand(AI_BENCH_SEED);
+    for (GameState& state : states)
     {
-        g_model_matrix_p1_win = glm::mat4(1.0f);
-        p1_win_scale = glm::vec3(10.0f, 8.0f, 8.0f);
-        g_model_matrix_p1_win = glm::scale(g_model_matrix_p1_win, p1_win_scale);
-        game_ended = true;
+        simulation_reset(state);
+        state.tumbleweed_movement.y = glm::linearRand(-1.0f, 1.0f);
     }
-    if (tumbleweed_position.x < -11.0f)
+
+    std::vector<float> tumbleweed_x(count), tumbleweed_y(count), movement_x(count), movement_y(count),
+        left_cowboy_y(count), right_cowboy_y(count);
+    std::vector<uint8_t> left_inputs(count), right_inputs(count);
+
+    AiBatch batch;
+    batch.tumbleweed_x = tumbleweed_x.data();
+    batch.tumbleweed_y = tumbleweed_y.data();
+    batch.tumbleweed_movement_x = movement_x.data();
+    batch.tumbleweed_movement_y = movement_y.data();
+    batch.count = count;
+
+    int ticks = (int)(g_ai_bench_seconds / FIXED_TIMESTEP);
+    double ai_seconds = 0.0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int tick = 0; tick < ticks; tick++)
     {
-        g_model_matrix_p2_win = glm::mat4(1.0f);
-        p2_win_scale = glm::vec3(10.0f, 8.0f, 8.0f);
-        g_model_matrix_p2_win = glm::scale(g_model_matrix_p2_win, p2_win_scale);
-        game_ended = true;
+        for (size_t i = 0; i < count; i++)
+        {
+            tumbleweed_x[i] = states[i].tumbleweed_position.x;
+            tumbleweed_y[i] = states[i].tumbleweed_position.y;
+            movement_x[i] = states[i].tumbleweed_movement.x;
+            movement_y[i] = states[i].tumbleweed_movement.y;
+            left_cowboy_y[i] = states[i].left_cowboy_position.y;
+            right_cowboy_y[i] = states[i].right_cowboy_position.y;
+        }
+
+        std::chrono::steady_clock::time_point ai_start = std::chrono::steady_clock::now();
+        batch.cowboy_y = left_cowboy_y.data();
+        batch.inputs = left_inputs.data();
+        ai_choose_inputs(batch, 0);
+        batch.cowboy_y = right_cowboy_y.data();
+        batch.inputs = right_inputs.data();
+        ai_choose_inputs(batch, 1);
+        ai_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - ai_start).count();
+
+        for (size_t i = 0; i < count; i++) simulation_step(states[i], left_inputs[i] | right_inputs[i]);
     }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int wins[3] = { 0, 0, 0 };
+    for (const GameState& state : states) wins[state.winner]++;
+
+    double paddle_ticks = 2.0 * count * (ticks > 0 ? ticks : 1);
+    LOG(count << " matches, " << ticks << " ticks in " << seconds << "s");
+    LOG("AI: " << ai_seconds * 1e9 / paddle_ticks << " ns per paddle per tick");
+    LOG("p1 wins " << wins[1] << ", p2 wins " << wins[2] << ", unfinished " << wins[0]);
+    return 0;
+}
+
+// returns the process exit code: 1 if there's no offscreen context or the golden image differs
+int run_headless()
+{
+    if (!headless_initialise(WINDOW_WIDTH, WINDOW_HEIGHT)) return 1;
+    initialise_scene();
+    g_textures.finish(); // golden images need every texture in the first frame
+
+    // the AI plays both sides so every run draws the same frames
+    std::vector<double> frame_ms;
+    frame_ms.reserve(g_headless_frames);
+    for (int i = 0; i < g_headless_frames; i++)
+    {
+        for (int tick = 0; tick < HEADLESS_TICKS_PER_FRAME; tick++)
+        {
+            g_previous_state = g_state;
+            simulation_step(g_state, ai_choose_input(g_state, 0) | ai_choose_input(g_state, 1));
+        }
+        g_interpolation_alpha = 1.0f;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        RenderFrame frame;
+        build_render_frame(frame);
+        render_frame(frame);
+        frame_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    double total_ms = 0.0;
+    for (double ms : frame_ms) total_ms += ms;
+    std::sort(frame_ms.begin(), frame_ms.end());
+    LOG(g_headless_frames << " frames, mean " << total_ms / g_headless_frames << "ms, min " << frame_ms.front()
+        << "ms, p50 " << frame_ms[frame_ms.size() / 2] << "ms, p99 " << frame_ms[frame_ms.size() * 99 / 100]
+        << "ms, max " << frame_ms.back() << "ms");
+
+    int exit_code = 0;
+    std::vector<uint8_t> pixels;
+    headless_read_pixels(pixels);
+
+    if (g_write_golden_path != NULL)
+    {
+        if (write_ppm(g_write_golden_path, WINDOW_WIDTH, WINDOW_HEIGHT, pixels)) LOG("Golden image written to " << g_write_golden_path);
+        else LOG("Unable to write golden image to " << g_write_golden_path);
+    }
+
+    if (g_golden_path != NULL)
+    {
+        int golden_width, golden_height;
+        std::vector<uint8_t> golden;
+        if (!read_ppm(g_golden_path, golden_width, golden_height, golden))
+        {
+            LOG(g_golden_path << ": unable to load golden image");
+            exit_code = 1;
+        }
+        else if (golden_width != WINDOW_WIDTH || golden_height != WINDOW_HEIGHT)
+        {
+            LOG(g_golden_path << ": golden image is " << golden_width << "x" << golden_height);
+            exit_code = 1;
+        }
+        else
+        {
+            int differing_pixels = 0;
+            for (size_t i = 0; i < pixels.size(); i += 3)
+            {
+                if (memcmp(&pixels[i], &golden[i], 3) != 0) differing_pixels++;
+            }
+
+            if (differing_pixels == 0) LOG(g_golden_path << ": match");
+            else LOG(g_golden_path << ": MISMATCH in " << differing_pixels << " pixels");
+            exit_code = differing_pixels == 0 ? 0 : 1;
+        }
+    }
+
+    g_frame_capture.stop();
+    g_shader_watcher.stop();
+    g_texture_uploader.stop();
+    g_textures.shutdown();
+    g_sprite_stream.shutdown();
+    g_gpu_timer.shutdown();
+    headless_shutdown();
+
+    if (g_profile_output_path != NULL)
+    {
+        if (profiler_write_chrome_trace(g_profile_output_path)) LOG("Profile written to " << g_profile_output_path);
+        else LOG("Unable to write profile to " << g_profile_output_path);
+    }
+    return exit_code;
+}
+
+// returns the process exit code: 1 if any image couldn't be baked
+int run_bake()
+{
+    int thread_count = (int)std::thread::hardware_concurrency();
+    return bake_textures(g_bake_paths, g_bake_target, thread_count > 0 ? thread_count : 1) ? 0 : 1;
+}
+
+// loads a texture to be used by OpenGL; it's transparent until the uploader
+// has decoded and uploaded the image, and may be freed and reloaded later to
+// stay within the texture budget, see TextureResidency
+TextureHandle load_texture(const char* filepath)
+{
+    PROFILE_ZONE("load_texture");
+    TextureHandle texture = g_textures.add(filepath);
+    g_textures.prefetch(texture);
+    return texture;
 }
 
 // initialises all game objects and code
@@ -195,16 +588,36 @@ void initialise()
         WINDOW_WIDTH, WINDOW_HEIGHT,
         SDL_WINDOW_OPENGL);
 
-    SDL_GLContext context = SDL_GL_CreateContext(g_display_window);
-    SDL_GL_MakeCurrent(g_display_window, context);
+    g_gl_context = SDL_GL_CreateContext(g_display_window);
+    SDL_GL_MakeCurrent(g_display_window, g_gl_context);
 
     // for windows machines
 #ifdef _WINDOWS
     glewInit();
 #endif
 
+    initialise_scene();
+
+    // hand the context over to the render thread
+    SDL_GL_MakeCurrent(g_display_window, NULL);
+    g_render_thread.start(g_display_window, g_gl_context, render_frame, &g_frame_pacer);
+
+    // start timing from here so loading isn't counted as the first frame
+    g_previous_counter = SDL_GetPerformanceCounter();
+ }
+
+// GL state, shaders, textures and the starting game state, needs a current context
+void initialise_scene()
+{
     glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
-    g_shader_program.load(V_SHADER_PATH, F_SHADER_PATH);
+    if (g_profile_output_path != NULL || g_show_gpu_timing) g_gpu_timer.initialise();
+    g_shader_program.load(V_SHADER_PATH, F_SHADER_PATH, PROGRAM_CACHE_PATH);
+    if (g_hot_reload && !g_shader_watcher.start("shaders", V_SHADER_PATH, F_SHADER_PATH))
+    {
+        LOG("Unable to watch shaders for changes, hot reload disabled");
+        g_hot_reload = false;
+    }
+    g_sprite_stream.initialise(MAX_SPRITE_COMMANDS * SPRITE_VERTEX_COUNT * sizeof(SpriteVertex));
 
     // initialize all model matrixes
     g_model_matrix_left_cowboy = glm::mat4(1.0f);
@@ -225,16 +638,25 @@ void initialise()
     g_model_matrix_left_cowboy = glm::scale(g_model_matrix_left_cowboy, cowboy_scale);
     g_model_matrix_right_cowboy = glm::scale(g_model_matrix_right_cowboy, cowboy_scale);
     g_model_matrix_tumbleweed = glm::scale(g_model_matrix_tumbleweed, tumbleweed_scale);
-    g_model_matrix_p1_win = glm::scale(g_model_matrix_p1_win, p1_win_scale);
-    g_model_matrix_p2_win = glm::scale(g_model_matrix_p2_win, p2_win_scale);
-    left_cowboy_position.x = -offset;
-    right_cowboy_position.x = offset;
+    g_model_matrix_p1_win = glm::scale(g_model_matrix_p1_win, glm::vec3(0.0f));
+    g_model_matrix_p2_win = glm::scale(g_model_matrix_p2_win, glm::vec3(0.0f));
 
-    // initialize movement
-    tumbleweed_movement.x = 1.0f;
-    tumbleweed_movement.y = 0.5f;
+    // initialize positions and movement
+    simulation_reset(g_state);
+    g_previous_state = g_state;
+
+    if (g_netplay)
+    {
+        LoopbackTransport::connect(g_local_transport, g_remote_transport);
+        g_local_transport.set_conditions(g_loopback_latency_ms, g_loopback_latency_ms * 0.25f, g_loopback_loss);
+        g_remote_transport.set_conditions(g_loopback_latency_ms, g_loopback_latency_ms * 0.25f, g_loopback_loss);
+        g_local_session.start(0, &g_local_transport);
+        g_remote_session.start(1, &g_remote_transport);
+    }
 
     // load the textures with the images
+    g_texture_uploader.start();
+    g_textures.initialise(&g_texture_uploader, g_texture_budget_mb * 1024 * 1024);
     left_cowboy_texture_id = load_texture(LEFT_COWBOY_SPRITE);
     right_cowboy_texture_id = load_texture(RIGHT_COWBOY_SPRITE);
     tumbleweed_texture_id = load_texture(TUMBLEWEED_SPRITE);
@@ -245,187 +667,419 @@ void initialise()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
- }
 
-std::pair<bool, int> wall_check(glm::vec3& tumbleweed_pos, glm::vec3& tumbleweed_move, 
-    float offset)
-{
-    float wall = WALL_BORDER + offset;
-    if (tumbleweed_pos.y > wall) return std::make_pair(true, 1);
-    if (tumbleweed_pos.y < -wall) return std::make_pair(true, -1);
-    return std::make_pair(false, 0);
+    // offscreen frames aren't shown, so nothing is lost by waiting for the writer
+    if (g_capture_path != NULL && !g_frame_capture.start(g_capture_path, VIEWPORT_WIDTH, VIEWPORT_HEIGHT,
+        CAPTURE_FRAMES_PER_SECOND, g_headless_frames > 0))
+    {
+        LOG("Unable to open " << g_capture_path << ", not capturing");
+    }
 }
 
-void limit_to_border(glm::vec3& position, glm::vec3& movement)
+void run_game_loop()
 {
-    std::pair<bool, int> wall_check_outcome = wall_check(position, movement, 0.0f);
-    if (wall_check_outcome.first)
+    profiler_set_thread_name("game");
+    if (g_netplay) glm::seedRand(LOOPBACK_SEED);
+
+    while (g_game_is_running)
     {
-        position.y = WALL_BORDER * wall_check_outcome.second;
-        movement.y = 0;
+        PROFILE_ZONE("frame");
+        pace_frame(); // wait for the frame to start, so input is read as late as possible
+        update(); // update the game state, run every frame
+        render(); // show the game state (after update to show changes in game state)
     }
 }
 
-void cowboy_check(glm::vec3& tumbleweed_pos, const glm::vec3& tumbleweed_size,
-    glm::vec3& obstacle_pos, const glm::vec3& obstacle_size, bool is_left)
+void pace_frame()
 {
-    float collision_factor = 0.02f;
-
-    float x_distance = fabs(tumbleweed_pos.x - (obstacle_pos.x + (is_left ? -offset : offset))) -
-        ((tumbleweed_size.x + obstacle_size.x * 2.0f) / 2.0f);
-    float y_distance = fabs(tumbleweed_pos.y - obstacle_pos.y) -
-        ((tumbleweed_size.y * 2.5f + obstacle_size.y * 2.5f) / 2.0f);
+    // locked to vsync, start once the last frame is on screen; otherwise once
+    // the render thread has room for another, then on the pacer's schedule
+    if (g_frame_pacer.waits_for_present()) g_render_thread.wait_for_present();
+    else if (g_frame_pacer.waits_for_render_thread()) g_render_thread.wait_for_free_slot();
+    g_frame_pacer.wait_for_next_frame();
+}
 
-    if (x_distance < 0.0f && y_distance < 0.0f)
+static uint8_t input_bit_for(SDL_Scancode scancode)
+{
+    switch (scancode)
     {
-        tumbleweed_movement.x *= -1.0f;
+        // left cowboy controls
+        case SDL_SCANCODE_W: return INPUT_LEFT_UP;
+        case SDL_SCANCODE_S: return INPUT_LEFT_DOWN;
+        // right cowboy controls
+        case SDL_SCANCODE_UP: return INPUT_RIGHT_UP;
+        case SDL_SCANCODE_DOWN: return INPUT_RIGHT_DOWN;
+        default: return 0;
     }
 }
 
-void wall_bounce(glm::vec3& tumbleweed_pos, glm::vec3& tumbleweed_move)
+// SDL stamps each event with SDL_GetTicks() when it queued it, so an event
+// that sat out the rest of the wait keeps its own time; its age moves it onto
+// the profiler clock. Ticks are whole milliseconds, so times are good to
+// within 1 ms rather than the INPUT_WAIT_MS an event may have waited.
+static uint64_t input_event_time_ns(Uint32 timestamp, uint64_t now_ns, Uint32 now_ticks)
 {
-    std::pair<bool, int> wall_check_outcome = 
-        wall_check(tumbleweed_pos, tumbleweed_move, 4.0f);
-    if (wall_check_outcome.first)
-    {
-        tumbleweed_move.y *= -1.0f;
-    }
+    Uint32 age_ms = now_ticks - timestamp;
+    if ((Sint32)age_ms < 0) age_ms = 0; // stamped after now_ticks was read
+    uint64_t age_ns = (uint64_t)age_ms * 1000000;
+    uint64_t time_ns = age_ns < now_ns ? now_ns - age_ns : 1; // 0 means no input, see g_input_time_ns
+
+    // consume_input_events() stops at the first event past the tick, so keep them in order
+    if (time_ns < g_last_input_time_ns) time_ns = g_last_input_time_ns;
+    g_last_input_time_ns = time_ns;
+    return time_ns;
 }
 
+// waits up to INPUT_WAIT_MS for events and queues them for the game thread
 void process_input()
 {
     SDL_Event event;
-    while (SDL_PollEvent(&event))
+    if (!SDL_WaitEventTimeout(&event, INPUT_WAIT_MS)) return;
+
+    PROFILE_ZONE("process_input");
+    uint64_t now_ns = profiler_now_ns();
+    Uint32 now_ticks = SDL_GetTicks();
+    do
     {
+        InputEvent input_event;
+        input_event.input_bit = 0;
+
         switch (event.type)
         {
             case SDL_QUIT:
             case SDL_WINDOWEVENT_CLOSE:
                 // check if game is quit
                 g_game_is_running = false;
-                break;
+                continue;
             case SDL_KEYDOWN:
-                switch (event.key.keysym.sym)
+            case SDL_KEYUP:
+                if (event.key.repeat) continue;
+                if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_t)
                 {
-                case SDLK_t:
-                    singleplayer = !singleplayer;
+                    input_event.type = INPUT_EVENT_TOGGLE_SINGLEPLAYER;
                 }
+                else
+                {
+                    input_event.type = event.type == SDL_KEYDOWN ? INPUT_EVENT_PRESS : INPUT_EVENT_RELEASE;
+                    input_event.input_bit = input_bit_for(event.key.keysym.scancode);
+                    if (input_event.input_bit == 0) continue;
+                }
+                input_event.time_ns = input_event_time_ns(event.key.timestamp, now_ns, now_ticks);
+                // the game thread is far behind if this fills up, dropping is all we can do
+                g_input_events.try_push(input_event);
+                break;
         }
-    }
+    } while (SDL_PollEvent(&event));
+}
 
-    const Uint8* key_state = SDL_GetKeyboardState(NULL); // if keyboard is not null
+// applies the queued key changes up to the given time and returns the input
+// for the tick ending then; a press and release within one tick still counts
+uint8_t consume_input_events(uint64_t until_ns)
+{
+    uint8_t pressed_input = 0;
 
-    // left cowboy controls
-    if (key_state[SDL_SCANCODE_W])
-    {
-        left_cowboy_movement.y = 1.0f;
-    }
-    if (key_state[SDL_SCANCODE_S])
+    const InputEvent* input_event;
+    while ((input_event = g_input_events.peek()) != NULL && input_event->time_ns <= until_ns)
     {
-        left_cowboy_movement.y = -1.0f;
+        // events are queued in order, so the first one this frame is the oldest
+        if (g_input_time_ns == 0) g_input_time_ns = input_event->time_ns;
+
+        switch (input_event->type)
+        {
+            case INPUT_EVENT_PRESS:
+                g_held_input |= input_event->input_bit;
+                pressed_input |= input_event->input_bit;
+                break;
+            case INPUT_EVENT_RELEASE:
+                g_held_input &= ~input_event->input_bit;
+                break;
+            case INPUT_EVENT_TOGGLE_SINGLEPLAYER:
+                singleplayer = !singleplayer;
+                break;
+        }
+
+        InputEvent consumed;
+        g_input_events.try_pop(consumed);
     }
 
-    if (!singleplayer)
+    uint8_t input = g_held_input | pressed_input;
+    if (singleplayer) input &= ~(INPUT_RIGHT_UP | INPUT_RIGHT_DOWN);
+    return input;
+}
+
+void update()
+{
+    PROFILE_ZONE("update");
+
+    // calculate time
+    Uint64 counter = SDL_GetPerformanceCounter();
+    uint64_t now_ns = profiler_now_ns();
+    g_input_time_ns = 0;
+    float delta_time = (float)(counter - g_previous_counter) / (float)SDL_GetPerformanceFrequency();
+    g_previous_counter = counter;
+    if (delta_time > MAX_FRAME_TIME) delta_time = MAX_FRAME_TIME;
+
+    // step the simulation at a fixed rate no matter how long the frame took
+    g_accumulator += delta_time;
+    while (g_accumulator >= FIXED_TIMESTEP)
     {
-        // right cowboy controls
-        if (key_state[SDL_SCANCODE_UP])
+        // this tick covers up to (accumulator - timestep) seconds before now
+        uint64_t tick_end_ns = now_ns - (uint64_t)((g_accumulator - FIXED_TIMESTEP) * 1e9f);
+        uint8_t player_input = consume_input_events(tick_end_ns);
+
+        g_previous_state = g_state;
+        if (g_netplay)
         {
-            right_cowboy_movement.y = 1.0f;
+            // each session only takes its own player's bits from the shared keyboard
+            g_local_session.advance(player_input);
+            g_remote_session.advance(singleplayer ? ai_choose_input(g_remote_session.get_state(), 1) : player_input);
+            g_state = g_local_session.get_state();
         }
-        if (key_state[SDL_SCANCODE_DOWN])
+        else
         {
-            right_cowboy_movement.y = -1.0f;
+            uint8_t input = player_input;
+            if (singleplayer) input |= ai_choose_input(g_state, 1);
+
+            simulation_step(g_state, input);
+            if (g_record_output_path != NULL) g_recording.inputs.push_back(input);
         }
+
+        g_accumulator -= FIXED_TIMESTEP;
     }
+
+    // how far between the last two steps the frame is drawn
+    g_interpolation_alpha = g_accumulator / FIXED_TIMESTEP;
 }
 
-void update()
+// builds the sprite transforms from positions blended between the previous and current step
+void interpolate_model_matrices(float alpha)
 {
-    if (!game_ended)
-    {
-        // calculate time
-        float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND; // get the current number of ticks
-        float delta_time = ticks - g_previous_ticks; // the delta time is the difference from the last frame
-        g_previous_ticks = ticks;
-
-        // multiple movement by speed and time for both
-        left_cowboy_position += left_cowboy_movement * COWBOY_MOVEMENT_SPEED * delta_time;
-        right_cowboy_position += right_cowboy_movement * COWBOY_MOVEMENT_SPEED * delta_time;
-        tumbleweed_position += tumbleweed_movement * TUMBLEWEED_SPEED * delta_time;
-
-        // reset
-        g_model_matrix_left_cowboy = glm::mat4(1.0f);
-        g_model_matrix_right_cowboy = glm::mat4(1.0f);
-        g_model_matrix_tumbleweed = glm::mat4(1.0f);
-        g_model_matrix_left_cowboy = glm::scale(g_model_matrix_left_cowboy, cowboy_scale);
-        g_model_matrix_right_cowboy = glm::scale(g_model_matrix_right_cowboy, cowboy_scale);
-        g_model_matrix_tumbleweed = glm::scale(g_model_matrix_tumbleweed, tumbleweed_scale);
-
-        // limit the cowboys' vertical movement to within the screen
-        limit_to_border(left_cowboy_position, left_cowboy_movement);
-        limit_to_border(right_cowboy_position, right_cowboy_movement);
-
-        // move the objects
-        g_model_matrix_left_cowboy = glm::translate(g_model_matrix_left_cowboy, left_cowboy_position);
-        g_model_matrix_right_cowboy = glm::translate(g_model_matrix_right_cowboy, right_cowboy_position);
-        g_model_matrix_tumbleweed = glm::translate(g_model_matrix_tumbleweed, tumbleweed_position);
-
-        // bounce off surfaces
-        cowboy_check(tumbleweed_position, tumbleweed_scale,
-            left_cowboy_position, cowboy_scale, true);
-        cowboy_check(tumbleweed_position, tumbleweed_scale,
-            right_cowboy_position, cowboy_scale, false);
-        wall_bounce(tumbleweed_position, tumbleweed_movement);
-
-        check_for_game_end();
-    }
+    g_model_matrix_left_cowboy = glm::scale(glm::mat4(1.0f), cowboy_scale);
+    g_model_matrix_right_cowboy = glm::scale(glm::mat4(1.0f), cowboy_scale);
+    g_model_matrix_tumbleweed = glm::scale(glm::mat4(1.0f), tumbleweed_scale);
+
+    g_model_matrix_left_cowboy = glm::translate(g_model_matrix_left_cowboy,
+        glm::mix(g_previous_state.left_cowboy_position, g_state.left_cowboy_position, alpha));
+    g_model_matrix_right_cowboy = glm::translate(g_model_matrix_right_cowboy,
+        glm::mix(g_previous_state.right_cowboy_position, g_state.right_cowboy_position, alpha));
+    g_model_matrix_tumbleweed = glm::translate(g_model_matrix_tumbleweed,
+        glm::mix(g_previous_state.tumbleweed_position, g_state.tumbleweed_position, alpha));
+
+    g_model_matrix_p1_win = glm::scale(glm::mat4(1.0f), g_state.winner == 1 ? win_scale : glm::vec3(0.0f));
+    g_model_matrix_p2_win = glm::scale(glm::mat4(1.0f), g_state.winner == 2 ? win_scale : glm::vec3(0.0f));
 }
 
-void draw_object(glm::mat4& object_model_matrix, GLuint& object_texture_id)
+void draw_object(GLuint object_texture_id, int first_vertex)
 {
-    g_shader_program.set_model_matrix(object_model_matrix);
     glBindTexture(GL_TEXTURE_2D, object_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, 6); // for the two halves of an image texture
+    glDrawArrays(GL_TRIANGLES, first_vertex, SPRITE_VERTEX_COUNT);
+}
+
+void write_sprite_vertices(SpriteVertex* vertices, const glm::mat4& model_matrix)
+{
+    for (int i = 0; i < SPRITE_VERTEX_COUNT; i++)
+    {
+        glm::vec4 position = model_matrix * glm::vec4(SPRITE_QUAD_POSITIONS[i * 2], SPRITE_QUAD_POSITIONS[i * 2 + 1], 0.0f, 1.0f);
+        vertices[i].x = position.x;
+        vertices[i].y = position.y;
+        vertices[i].u = SPRITE_QUAD_TEXTURE_COORDINATES[i * 2];
+        vertices[i].v = SPRITE_QUAD_TEXTURE_COORDINATES[i * 2 + 1];
+    }
 }
 
+// records this frame's sprites for the render thread
 void render()
 {
-    glClear(GL_COLOR_BUFFER_BIT);
+    PROFILE_ZONE("render");
+
+    RenderFrame frame;
+    build_render_frame(frame);
 
-    // Vertices
-    float vertices[] = {
-        -0.5f, -0.5f, 0.5f, -0.5f, 0.5f, 0.5f,  // triangle 1
-        -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f   // triangle 2
-    };
+    g_render_thread.submit(frame);
+}
 
-    // Textures
-    float texture_coordinates[] = {
-        0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f,     // triangle 1
-        0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f,     // triangle 2
-    };
+void build_render_frame(RenderFrame& frame)
+{
+    interpolate_model_matrices(g_interpolation_alpha);
 
-    glVertexAttribPointer(g_shader_program.get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
+    g_cull_stats = CullStats();
+
+    submit_sprite(frame, g_model_matrix_left_cowboy, left_cowboy_texture_id);
+    submit_sprite(frame, g_model_matrix_right_cowboy, right_cowboy_texture_id);
+    submit_sprite(frame, g_model_matrix_tumbleweed, tumbleweed_texture_id);
+    submit_sprite(frame, g_model_matrix_p1_win, p1_win_texture_id); // zero scale until someone wins
+    submit_sprite(frame, g_model_matrix_p2_win, p2_win_texture_id);
+    frame.input_time_ns = g_input_time_ns;
+
+    profiler_record_counter("sprites_drawn", g_cull_stats.drawn);
+    profiler_record_counter("sprites_culled", g_cull_stats.culled);
+}
+
+// skips sprites with no area or entirely off screen
+void submit_sprite(RenderFrame& frame, const glm::mat4& model_matrix, TextureHandle texture_id)
+{
+    if (!sprite_is_visible(model_matrix, g_projection_matrix * g_view_matrix))
+    {
+        g_cull_stats.culled++;
+        return;
+    }
+
+    frame.add_sprite(model_matrix, texture_id);
+    g_cull_stats.drawn++;
+}
+
+// the window belongs to the main thread, so the GPU timings are shown from here
+void update_window_title()
+{
+    Uint32 ticks = SDL_GetTicks();
+    if (g_show_gpu_timing && ticks - g_gpu_timing_last_ticks >= GPU_TIMING_REFRESH_MS)
+    {
+        char title[256];
+        {
+            std::lock_guard<std::mutex> lock(g_gpu_timing_mutex);
+            snprintf(title, sizeof(title), "HW 2!!!! | GPU %s", g_gpu_timing_text);
+        }
+        SDL_SetWindowTitle(g_display_window, title);
+        g_gpu_timing_last_ticks = ticks;
+    }
+}
+
+// draws a frame, runs on the render thread
+void render_frame(const RenderFrame& frame)
+{
+    PROFILE_ZONE("render_frame");
+
+    if (g_hot_reload) reload_shaders();
+    g_textures.begin_frame();
+
+    g_gpu_timer.begin_frame();
+
+    g_gpu_timer.begin_pass("clear");
+    glClear(GL_COLOR_BUFFER_BIT);
+    g_gpu_timer.end_pass();
+
+    // Vertices, already in world space so the model matrix stays identity
+    g_sprite_stream.begin_frame();
+    size_t vertex_offset = 0;
+    SpriteVertex* vertices = (SpriteVertex*)g_sprite_stream.allocate(
+        frame.sprite_count * SPRITE_VERTEX_COUNT * sizeof(SpriteVertex), vertex_offset);
+    for (int i = 0; i < frame.sprite_count; i++)
+    {
+        write_sprite_vertices(&vertices[i * SPRITE_VERTEX_COUNT], frame.sprites[i].model_matrix);
+    }
+    g_sprite_stream.flush();
+
+    g_shader_program.set_model_matrix(glm::mat4(1.0f));
+
+    glVertexAttribPointer(g_shader_program.get_position_attribute(), 2, GL_FLOAT, false, sizeof(SpriteVertex),
+        (const void*)(vertex_offset + offsetof(SpriteVertex, x)));
     glEnableVertexAttribArray(g_shader_program.get_position_attribute());
 
-    glVertexAttribPointer(g_shader_program.get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, texture_coordinates);
+    glVertexAttribPointer(g_shader_program.get_tex_coordinate_attribute(), 2, GL_FLOAT, false, sizeof(SpriteVertex),
+        (const void*)(vertex_offset + offsetof(SpriteVertex, u)));
     glEnableVertexAttribArray(g_shader_program.get_tex_coordinate_attribute());
 
     // Bind textures
-    draw_object(g_model_matrix_left_cowboy, left_cowboy_texture_id);
-    draw_object(g_model_matrix_right_cowboy, right_cowboy_texture_id);
-    draw_object(g_model_matrix_tumbleweed, tumbleweed_texture_id);
-    draw_object(g_model_matrix_p1_win, p1_win_texture_id);
-    draw_object(g_model_matrix_p2_win, p2_win_texture_id);
+    g_gpu_timer.begin_pass("sprites");
+    for (int i = 0; i < frame.sprite_count; i++)
+    {
+        draw_object(g_textures.use(frame.sprites[i].texture), i * SPRITE_VERTEX_COUNT);
+    }
+    g_gpu_timer.end_pass();
 
     // Disable
     glDisableVertexAttribArray(g_shader_program.get_position_attribute());
     glDisableVertexAttribArray(g_shader_program.get_tex_coordinate_attribute());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    g_sprite_stream.end_frame();
+    g_textures.end_frame();
 
-    SDL_GL_SwapWindow(g_display_window);
+    // before the swap, while the back buffer still holds this frame
+    if (g_frame_capture.is_running()) g_frame_capture.capture();
+
+    {
+        // CPU time only, a swap isn't GPU work a timer query can measure
+        PROFILE_ZONE("swap_window");
+        // nothing to swap offscreen, wait for the GPU so frame times include its work
+        if (g_headless_frames > 0) glFinish();
+        else SDL_GL_SwapWindow(g_display_window);
+    }
+
+    // only frames that apply new input have a latency to measure
+    if (g_measure_latency && frame.input_time_ns != 0) g_latency_histogram.record(profiler_now_ns() - frame.input_time_ns);
+
+    g_gpu_timer.end_frame();
+
+    if (g_show_gpu_timing)
+    {
+        std::lock_guard<std::mutex> lock(g_gpu_timing_mutex);
+        g_gpu_timer.format_summary(g_gpu_timing_text, sizeof(g_gpu_timing_text));
+    }
+}
+
+// runs on the render thread before a frame is drawn, so no frame sees half a swap
+void reload_shaders()
+{
+    std::string vertex_source, fragment_source;
+    if (g_shader_watcher.take_changed_sources(vertex_source, fragment_source))
+    {
+        // a newer save replaces a compile still in flight
+        if (g_shader_reload_pending) g_reloading_shader_program.cleanup();
+        g_reloading_shader_program.load_async(vertex_source, fragment_source);
+        g_shader_reload_pending = true;
+    }
+
+    // with parallel compile the driver links in the background, check back next frame
+    if (!g_shader_reload_pending || !g_reloading_shader_program.is_ready()) return;
+    g_shader_reload_pending = false;
+
+    if (!g_reloading_shader_program.finish_load())
+    {
+        LOG("Shader reload failed, keeping the old program");
+        g_reloading_shader_program.cleanup();
+        return;
+    }
+
+    g_shader_program.cleanup();
+    g_shader_program = g_reloading_shader_program;
+    g_shader_program.set_projection_matrix(g_projection_matrix);
+    g_shader_program.set_view_matrix(g_view_matrix);
+    LOG("Shaders reloaded");
 }
 
 // shutdown safely
 void shutdown()
 {
+    g_render_thread.stop();
+    SDL_GL_MakeCurrent(g_display_window, g_gl_context);
+    g_frame_capture.stop();
+    g_shader_watcher.stop();
+    g_texture_uploader.stop();
+    g_textures.shutdown();
+    g_sprite_stream.shutdown();
+    g_gpu_timer.shutdown();
     SDL_Quit();
+
+    if (g_measure_latency) g_latency_histogram.print();
+
+    if (g_netplay)
+    {
+        LOG("Rollbacks: " << g_local_session.get_rollback_count() << " resimulating "
+            << g_local_session.get_rollback_ticks() << " ticks, desyncs: " << g_local_session.get_desync_count()
+            << " in " << g_local_session.get_checksums_checked() << " checks, "
+            << g_local_session.get_checksums_skipped() << " checks skipped");
+    }
+
+    if (g_record_output_path != NULL)
+    {
+        g_recording.final_hash = simulation_hash(g_state);
+        if (replay_save(g_record_output_path, g_recording)) LOG("Replay written to " << g_record_output_path);
+        else LOG("Unable to write replay to " << g_record_output_path);
+    }
+
+    if (g_profile_output_path != NULL)
+    {
+        if (profiler_write_chrome_trace(g_profile_output_path)) LOG("Profile written to " << g_profile_output_path);
+        else LOG("Unable to write profile to " << g_profile_output_path);
+    }
 }
\ No newline at end of file
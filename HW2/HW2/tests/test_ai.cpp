@@ -0,0 +1,87 @@
+#include "test_common.h"
+#include "Ai.h"
+#include <cstdint>
+#include <vector>
+
+const size_t STATE_COUNT = 100003; // not a multiple of four, so the scalar tail runs too
+
+static uint32_t g_random = 2463534242u;
+
+static float random_float(float min, float max)
+{
+    g_random ^= g_random << 13;
+    g_random ^= g_random >> 17;
+    g_random ^= g_random << 5;
+    return min + (max - min) * (float)(g_random >> 8) / 16777216.0f;
+}
+
+// sideways speeds the fold is sensitive to: none, barely moving, either side
+// of AI_MIN_APPROACH_SPEED, and ordinary ones
+static float random_movement_x()
+{
+    switch (g_random % 8)
+    {
+        case 0: return 0.0f;
+        case 1: return -0.0f;
+        case 2: return random_float(-1e-6f, 1e-6f);
+        case 3: return random_float(-2e-3f, 2e-3f);
+        default: return random_float(-1.5f, 1.5f);
+    }
+}
+
+// the batch evaluator has to press exactly what the scalar one does, lane by lane
+static void test_batch_matches_scalar()
+{
+    std::vector<float> x(STATE_COUNT), y(STATE_COUNT), movement_x(STATE_COUNT), movement_y(STATE_COUNT),
+        cowboy_y(STATE_COUNT);
+    for (size_t i = 0; i < STATE_COUNT; i++)
+    {
+        x[i] = random_float(-20.0f, 20.0f);
+        // now and then far outside the field, where the fold's quotient is large
+        y[i] = i % 97 == 0 ? random_float(-1e8f, 1e8f) : random_float(-TUMBLEWEED_WALL, TUMBLEWEED_WALL);
+        movement_x[i] = random_movement_x();
+        movement_y[i] = random_float(-1.5f, 1.5f);
+        cowboy_y[i] = random_float(-WALL_BORDER, WALL_BORDER);
+    }
+
+    for (int player = 0; player < 2; player++)
+    {
+        std::vector<uint8_t> inputs(STATE_COUNT);
+        AiBatch batch;
+        batch.tumbleweed_x = x.data();
+        batch.tumbleweed_y = y.data();
+        batch.tumbleweed_movement_x = movement_x.data();
+        batch.tumbleweed_movement_y = movement_y.data();
+        batch.cowboy_y = cowboy_y.data();
+        batch.inputs = inputs.data();
+        batch.count = STATE_COUNT;
+        ai_choose_inputs(batch, player);
+
+        int mismatches = 0;
+        int pressed = 0;
+        for (size_t i = 0; i < STATE_COUNT; i++)
+        {
+            GameState state;
+            simulation_reset(state);
+            state.tumbleweed_position = glm::vec3(x[i], y[i], 0.0f);
+            state.tumbleweed_movement = glm::vec3(movement_x[i], movement_y[i], 0.0f);
+            (player == 0 ? state.left_cowboy_position : state.right_cowboy_position).y = cowboy_y[i];
+
+            uint8_t expected = ai_choose_input(state, player);
+            if (inputs[i] != expected && mismatches++ < 5)
+            {
+                std::printf("    player %d: x %.9g y %.9g movement %.9g %.9g cowboy %.9g: batch %d, scalar %d\n",
+                    player, x[i], y[i], movement_x[i], movement_y[i], cowboy_y[i], inputs[i], expected);
+            }
+            pressed += expected != 0;
+        }
+        CHECK(mismatches == 0);
+        CHECK(pressed > (int)STATE_COUNT / 4); // the states aren't all ones where it waits
+    }
+}
+
+int main()
+{
+    test_batch_matches_scalar();
+    return test_exit_code();
+}
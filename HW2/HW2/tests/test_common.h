@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdio>
+
+// Tests are plain executables run by ctest. CHECK reports a failed condition
+// and carries on so one run shows every failure; main returns
+// test_exit_code(), which is non-zero if anything failed.
+inline int& test_failure_count()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            test_failure_count()++; \
+        } \
+    } while (0)
+
+inline int test_exit_code()
+{
+    if (test_failure_count() > 0) std::printf("%d checks failed\n", test_failure_count());
+    return test_failure_count() > 0 ? 1 : 0;
+}
@@ -0,0 +1,242 @@
+#include "test_common.h"
+#include "glm/gtx/intersect.hpp"
+#include "glm/geometric.hpp"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Built once per glm code path, see add_glm_test. Not a multiple of four, so
+// the batched sphere test runs its scalar tail too.
+const std::size_t COUNT = 4099;
+const float MISS = std::numeric_limits<float>::infinity();
+
+static uint32_t g_random = 2463534242u;
+
+static float random_float(float min, float max)
+{
+    g_random ^= g_random << 13;
+    g_random ^= g_random >> 17;
+    g_random ^= g_random << 5;
+    return min + (max - min) * (float)(g_random >> 8) / 16777216.0f;
+}
+
+static glm::vec3 random_vec3(float min, float max)
+{
+    return glm::vec3(random_float(min, max), random_float(min, max), random_float(min, max));
+}
+
+// the swept box, a unit square, against one of the same size at the origin
+static bool sweep(const glm::vec2& center, const glm::vec2& displacement, float& time, glm::vec2& normal)
+{
+    return glm::intersectSweptAABB(center, glm::vec2(1.0f), displacement, glm::vec2(0.0f), glm::vec2(1.0f), time, normal);
+}
+
+static void test_swept_aabb_hit()
+{
+    float time = -1.0f;
+    glm::vec2 normal;
+    CHECK(sweep(glm::vec2(-5.0f, 0.5f), glm::vec2(8.0f, 0.0f), time, normal));
+    CHECK(time == 0.375f && normal == glm::vec2(-1.0f, 0.0f));
+
+    CHECK(sweep(glm::vec2(0.5f, 6.0f), glm::vec2(-1.0f, -8.0f), time, normal));
+    CHECK(time == 0.5f && normal == glm::vec2(0.0f, 1.0f));
+
+    // stops short, and touching at the very end of the move
+    CHECK(!sweep(glm::vec2(-5.0f, 0.0f), glm::vec2(2.0f, 0.0f), time, normal));
+    CHECK(sweep(glm::vec2(-5.0f, 0.0f), glm::vec2(3.0f, 0.0f), time, normal));
+    CHECK(time == 1.0f);
+}
+
+// already overlapping isn't a hit, whichever way the box moves; Simulation
+// separates those itself
+static void test_swept_aabb_overlapping_start()
+{
+    float time = -1.0f;
+    glm::vec2 normal(7.0f);
+    CHECK(!sweep(glm::vec2(1.0f, 0.5f), glm::vec2(-4.0f, 0.0f), time, normal));
+    CHECK(!sweep(glm::vec2(1.0f, 0.5f), glm::vec2(4.0f, 0.0f), time, normal));
+    CHECK(!sweep(glm::vec2(0.0f, 0.0f), glm::vec2(0.5f, -0.5f), time, normal));
+    CHECK(time == -1.0f && normal == glm::vec2(7.0f)); // left as they were
+
+    // but touching at the start and moving in is, at time zero
+    CHECK(sweep(glm::vec2(-2.0f, 0.0f), glm::vec2(1.0f, 0.0f), time, normal));
+    CHECK(time == 0.0f && normal == glm::vec2(-1.0f, 0.0f));
+}
+
+// sliding flush along a face, or meeting corner to corner, touches the obstacle
+static void test_swept_aabb_grazing()
+{
+    float time = -1.0f;
+    glm::vec2 normal;
+    CHECK(sweep(glm::vec2(-5.0f, -2.0f), glm::vec2(8.0f, 0.0f), time, normal));
+    CHECK(time == 0.375f && normal == glm::vec2(-1.0f, 0.0f));
+    CHECK(sweep(glm::vec2(2.0f, 5.0f), glm::vec2(0.0f, -4.0f), time, normal));
+    CHECK(time == 0.75f && normal == glm::vec2(0.0f, 1.0f));
+
+    CHECK(sweep(glm::vec2(-6.0f, -2.0f), glm::vec2(4.0f, 4.0f), time, normal));
+    CHECK(time == 1.0f && normal == glm::vec2(-1.0f, 0.0f));
+
+    // a float further out passes by
+    CHECK(!sweep(glm::vec2(-5.0f, std::nextafter(-2.0f, -3.0f)), glm::vec2(8.0f, 0.0f), time, normal));
+    CHECK(!sweep(glm::vec2(std::nextafter(2.0f, 3.0f), 5.0f), glm::vec2(0.0f, -4.0f), time, normal));
+}
+
+// not moving never enters the obstacle, however close or overlapping
+static void test_swept_aabb_zero_velocity()
+{
+    float time = -1.0f;
+    glm::vec2 normal(7.0f);
+    CHECK(!sweep(glm::vec2(-5.0f, 0.0f), glm::vec2(0.0f), time, normal));
+    CHECK(!sweep(glm::vec2(-2.0f, 0.0f), glm::vec2(0.0f), time, normal));
+    CHECK(!sweep(glm::vec2(0.5f, 0.5f), glm::vec2(0.0f), time, normal));
+    CHECK(!sweep(glm::vec2(-5.0f, 0.0f), glm::vec2(1e-9f, 0.0f), time, normal));
+    CHECK(time == -1.0f && normal == glm::vec2(7.0f));
+
+    // still along one axis only
+    CHECK(sweep(glm::vec2(-5.0f, 0.0f), glm::vec2(4.0f, 0.0f), time, normal));
+    CHECK(time == 0.75f && normal == glm::vec2(-1.0f, 0.0f));
+    CHECK(!sweep(glm::vec2(-5.0f, 3.0f), glm::vec2(4.0f, 0.0f), time, normal));
+}
+
+static glm::vec3 random_direction()
+{
+    glm::vec3 direction;
+    do direction = random_vec3(-1.0f, 1.0f);
+    while (glm::dot(direction, direction) < 0.01f);
+    return glm::normalize(direction);
+}
+
+// each lane of the batched tests gives exactly what the single ray test does,
+// hit or miss, for rays aimed near the object so both happen often
+
+static void test_ray_planes_match_scalar()
+{
+    glm::vec3 orig(0.5f, -1.0f, 2.0f);
+    glm::vec3 dir = random_direction();
+    std::vector<glm::vec3> origins(COUNT), normals(COUNT);
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        origins[i] = random_vec3(-10.0f, 10.0f);
+        normals[i] = i % 7 == 0 ? glm::normalize(glm::cross(dir, random_direction())) : random_direction();
+    }
+
+    std::vector<float> distances(COUNT);
+    std::size_t hits = glm::intersectRayPlanes(orig, dir, origins.data(), normals.data(), COUNT, distances.data());
+
+    std::size_t scalar_hits = 0;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        float distance;
+        bool hit = glm::intersectRayPlane(orig, dir, origins[i], normals[i], distance);
+        CHECK(hit ? distances[i] == distance : distances[i] == MISS);
+        scalar_hits += hit;
+    }
+    CHECK(hits == scalar_hits && hits > 0 && hits < COUNT);
+}
+
+static void test_ray_triangles_match_scalar()
+{
+    std::vector<glm::vec3> vert0(COUNT), vert1(COUNT), vert2(COUNT);
+    glm::vec3 orig(0.0f, 0.0f, -5.0f);
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        vert0[i] = random_vec3(-2.0f, 2.0f);
+        vert1[i] = random_vec3(-2.0f, 2.0f);
+        vert2[i] = random_vec3(-2.0f, 2.0f);
+    }
+
+    std::size_t hits = 0, scalar_hits = 0;
+    std::vector<glm::vec2> bary(COUNT);
+    std::vector<float> distances(COUNT);
+    for (int ray = 0; ray < 64; ray++)
+    {
+        // some straight through a vertex or along an edge, where rounding decides
+        glm::vec3 target = random_vec3(-1.0f, 1.0f);
+        if (ray % 4 == 1) target = vert0[ray];
+        if (ray % 4 == 2) target = (vert1[ray] + vert2[ray]) * 0.5f;
+        glm::vec3 dir = glm::normalize(target - orig);
+
+        hits += glm::intersectRayTriangles(orig, dir, vert0.data(), vert1.data(), vert2.data(), COUNT,
+            bary.data(), distances.data());
+        for (std::size_t i = 0; i < COUNT; i++)
+        {
+            glm::vec2 scalar_bary;
+            float distance;
+            bool hit = glm::intersectRayTriangle(orig, dir, vert0[i], vert1[i], vert2[i], scalar_bary, distance);
+            CHECK(hit ? distances[i] == distance && bary[i] == scalar_bary : distances[i] == MISS);
+            scalar_hits += hit;
+        }
+    }
+    CHECK(hits == scalar_hits && hits > 0);
+}
+
+static void test_ray_spheres_match_scalar()
+{
+    std::vector<glm::vec3> centers(COUNT);
+    std::vector<float> radius_squared(COUNT);
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        centers[i] = random_vec3(-10.0f, 10.0f);
+        radius_squared[i] = random_float(0.0f, 16.0f);
+    }
+    centers[5] = glm::vec3(0.0f); // the ray starts inside this one
+    radius_squared[5] = 4.0f;
+
+    glm::vec3 orig(0.0f);
+    std::vector<float> distances(COUNT);
+    for (int ray = 0; ray < 64; ray++)
+    {
+        glm::vec3 dir = random_direction();
+        std::size_t hits = glm::intersectRaySpheres(orig, dir, centers.data(), radius_squared.data(), COUNT,
+            distances.data());
+
+        std::size_t scalar_hits = 0;
+        for (std::size_t i = 0; i < COUNT; i++)
+        {
+            float distance;
+            bool hit = glm::intersectRaySphere(orig, dir, centers[i], radius_squared[i], distance);
+            CHECK(hit ? distances[i] == distance : distances[i] == MISS);
+            scalar_hits += hit;
+        }
+        CHECK(hits == scalar_hits && distances[5] < MISS);
+    }
+}
+
+static void test_rays_sphere_matches_scalar()
+{
+    glm::vec3 center(1.0f, 2.0f, -3.0f);
+    const float radius_squared = 9.0f;
+    std::vector<glm::vec3> origins(COUNT), directions(COUNT);
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        origins[i] = random_vec3(-10.0f, 10.0f);
+        directions[i] = glm::normalize(center + random_vec3(-4.0f, 4.0f) - origins[i]);
+    }
+
+    std::vector<float> distances(COUNT);
+    std::size_t hits = glm::intersectRaysSphere(origins.data(), directions.data(), COUNT, center, radius_squared,
+        distances.data());
+
+    std::size_t scalar_hits = 0;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        float distance;
+        bool hit = glm::intersectRaySphere(origins[i], directions[i], center, radius_squared, distance);
+        CHECK(hit ? distances[i] == distance : distances[i] == MISS);
+        scalar_hits += hit;
+    }
+    CHECK(hits == scalar_hits && hits > 0 && hits < COUNT);
+}
+
+int main()
+{
+    test_swept_aabb_hit();
+    test_swept_aabb_overlapping_start();
+    test_swept_aabb_grazing();
+    test_swept_aabb_zero_velocity();
+    test_ray_planes_match_scalar();
+    test_ray_triangles_match_scalar();
+    test_ray_spheres_match_scalar();
+    test_rays_sphere_matches_scalar();
+    return test_exit_code();
+}
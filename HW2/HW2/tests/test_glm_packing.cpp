@@ -0,0 +1,168 @@
+#include "test_common.h"
+#include "glm/gtc/packing.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Built once per glm code path, see add_glm_test. The bulk functions take
+// their SIMD path in whole blocks and the scalar one for the tail, so each
+// value is converted at the start of a block and again in the tail.
+const std::size_t BLOCK = 16;
+
+static uint32_t float_bits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_float(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// both positions of the bulk conversion, which have to agree
+static uint16_t bulk_pack_half(float value)
+{
+    float in[BLOCK + 1];
+    for (std::size_t i = 0; i <= BLOCK; i++) in[i] = value;
+    glm::uint16 out[BLOCK + 1];
+    glm::packHalf(in, out, BLOCK + 1);
+    CHECK(out[0] == out[BLOCK]);
+    return out[0];
+}
+
+static uint8_t bulk_pack_unorm(float value)
+{
+    float in[BLOCK + 1];
+    for (std::size_t i = 0; i <= BLOCK; i++) in[i] = value;
+    glm::uint8 out[BLOCK + 1];
+    glm::packUnorm(in, out, BLOCK + 1);
+    CHECK(out[0] == out[BLOCK]);
+    return out[0];
+}
+
+static int g_half_ties = 0;
+
+// the documented differences from packHalf1x16: ties round to even, NaNs come out quiet
+static void check_pack_half(float value)
+{
+    uint16_t bulk = bulk_pack_half(value);
+    uint16_t scalar = glm::packHalf1x16(value);
+    uint32_t bits = float_bits(value);
+
+    if (std::isnan(value))
+    {
+        CHECK(bulk == (((bits >> 16) & 0x8000) | 0x7e00 | ((bits >> 13) & 0x3ff)));
+        return;
+    }
+    if (std::fabs(value) >= 65520.0f)
+    {
+        CHECK(bulk == (((bits >> 16) & 0x8000) | 0x7c00));
+        return;
+    }
+    if (bulk == scalar) return;
+
+    // otherwise value lies exactly between the two
+    double to_bulk = std::fabs((double)value - glm::unpackHalf1x16(bulk));
+    double to_scalar = std::fabs((double)value - glm::unpackHalf1x16(scalar));
+    CHECK(to_bulk == to_scalar);
+    CHECK((bulk & 1) == 0);
+    if (to_bulk != to_scalar) std::printf("    packHalf(%.9g) = %04x, packHalf1x16 %04x\n", value, bulk, scalar);
+    g_half_ties++;
+}
+
+// every half, the points halfway to its neighbours and a float either side of those
+static void test_pack_half_over_half_range()
+{
+    for (uint32_t half = 0; half < 0x10000; half++)
+    {
+        if ((half & 0x7c00) == 0x7c00) continue; // infinities and NaNs have no neighbour above
+
+        float value = glm::unpackHalf1x16((glm::uint16)half);
+        check_pack_half(value);
+
+        float next = glm::unpackHalf1x16((glm::uint16)(half + 1));
+        if ((half & 0x7fff) == 0x7bff) next = std::copysign(65536.0f, value); // where infinity starts rounding
+        float midpoint = (float)(((double)value + next) / 2.0);
+        check_pack_half(midpoint);
+        check_pack_half(std::nextafter(midpoint, 0.0f));
+        check_pack_half(std::nextafter(midpoint, midpoint * 2.0f));
+    }
+    CHECK(g_half_ties > 0);
+}
+
+// a spread of every kind of float: NaN payloads, infinities, denormals, and
+// magnitudes far outside the half range
+static void test_pack_half_over_float_bits()
+{
+    for (uint64_t bits = 0; bits < 0x100000000ull; bits += 4093) check_pack_half(bits_float((uint32_t)bits));
+
+    check_pack_half(bits_float(0x7f800001)); // signaling NaN
+    check_pack_half(bits_float(0xffc00000)); // negative quiet NaN
+    check_pack_half(INFINITY);
+    check_pack_half(-INFINITY);
+}
+
+// exact for every half, apart from signaling NaNs coming out quiet
+static void test_unpack_half_over_half_range()
+{
+    glm::uint16 in[BLOCK + 1];
+    float out[BLOCK + 1];
+    for (uint32_t half = 0; half < 0x10000; half++)
+    {
+        for (std::size_t i = 0; i <= BLOCK; i++) in[i] = (glm::uint16)half;
+        glm::unpackHalf(in, out, BLOCK + 1);
+
+        uint32_t bulk = float_bits(out[0]);
+        uint32_t scalar = float_bits(glm::unpackHalf1x16((glm::uint16)half));
+        CHECK(bulk == float_bits(out[BLOCK]));
+
+        bool is_nan = (half & 0x7c00) == 0x7c00 && (half & 0x3ff) != 0;
+        CHECK(bulk == (is_nan ? (scalar | 0x00400000) : scalar));
+    }
+}
+
+// packUnorm1x8 rounds halves away from zero; the k + 0.5 points are where
+// rounding to even would differ
+static void test_pack_unorm()
+{
+    for (int k = 0; k < 255; k++)
+    {
+        float tie = (float)((k + 0.5) / 255.0);
+        float values[3] = { tie, std::nextafter(tie, 0.0f), std::nextafter(tie, 1.0f) };
+        for (float value : values) CHECK(bulk_pack_unorm(value) == glm::packUnorm1x8(value));
+    }
+
+    for (int i = -100000; i <= 1100000; i++)
+    {
+        float value = i / 1000000.0f;
+        CHECK(bulk_pack_unorm(value) == glm::packUnorm1x8(value));
+    }
+    CHECK(bulk_pack_unorm(-INFINITY) == 0);
+    CHECK(bulk_pack_unorm(INFINITY) == 255);
+}
+
+static void test_unpack_unorm()
+{
+    glm::uint8 in[256 + 1];
+    float out[256 + 1];
+    for (int i = 0; i < 256; i++) in[i] = (glm::uint8)i;
+    in[256] = 255;
+    glm::unpackUnorm(in, out, 256 + 1);
+
+    for (int i = 0; i < 256; i++) CHECK(float_bits(out[i]) == float_bits(glm::unpackUnorm1x8((glm::uint8)i)));
+    CHECK(out[256] == out[255]);
+}
+
+int main()
+{
+    test_pack_half_over_half_range();
+    test_pack_half_over_float_bits();
+    test_unpack_half_over_half_range();
+    test_pack_unorm();
+    test_unpack_unorm();
+    return test_exit_code();
+}
@@ -0,0 +1,123 @@
+#include "test_common.h"
+#include "glm/gtc/random.hpp"
+#include "glm/geometric.hpp"
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include <thread>
+#include <vector>
+
+const std::size_t COUNT = 10000;
+const float RADIUS = 3.0f;
+// rounding in the length of a vector drawn at the radius
+const float RADIUS_TOLERANCE = RADIUS * 1e-5f;
+
+static std::vector<float> draw_sequence(glm::uint64 seed)
+{
+    glm::seedRand(seed);
+    std::vector<float> values;
+    for (int i = 0; i < 100; i++) values.push_back(glm::linearRand(0.0f, 1.0f));
+
+    std::vector<glm::vec3> batch(64);
+    glm::ballRand(batch.data(), batch.size(), RADIUS);
+    for (const glm::vec3& value : batch) values.push_back(value.x + value.y + value.z);
+    return values;
+}
+
+// seedRand gives the same values for the same seed, on any thread, whatever
+// the thread drew before
+static void test_same_seed_reproduces()
+{
+    std::vector<float> first = draw_sequence(42);
+    glm::linearRand(0.0f, 1.0f);
+    CHECK(draw_sequence(42) == first);
+    CHECK(draw_sequence(43) != first);
+
+    std::vector<float> other_thread;
+    std::thread thread([&other_thread]() { other_thread = draw_sequence(42); });
+    thread.join();
+    CHECK(other_thread == first);
+}
+
+// scalar linearRand includes Max, the batch fill stops short of it
+static void test_linear_rand_in_range()
+{
+    glm::seedRand(1);
+    bool below_middle = false, above_middle = false;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        float value = glm::linearRand(-2.0f, 5.0f);
+        CHECK(value >= -2.0f && value <= 5.0f);
+        below_middle |= value < 1.5f;
+        above_middle |= value > 1.5f;
+    }
+    CHECK(below_middle && above_middle);
+
+    glm::vec2 min(-2.0f, 10.0f), max(5.0f, 10.5f);
+    std::vector<glm::vec2> batch(COUNT);
+    glm::linearRand(batch.data(), batch.size(), min, max);
+    glm::vec2 mean(0.0f);
+    for (const glm::vec2& value : batch)
+    {
+        CHECK(value.x >= min.x && value.x < max.x);
+        CHECK(value.y >= min.y && value.y < max.y);
+        mean += value / (float)COUNT;
+    }
+    CHECK(glm::abs(mean.x - 1.5f) < 0.1f && glm::abs(mean.y - 10.25f) < 0.01f);
+}
+
+static void test_disk_and_ball_inside_radius()
+{
+    glm::seedRand(2);
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        CHECK(glm::length(glm::diskRand(RADIUS)) <= RADIUS);
+        CHECK(glm::length(glm::ballRand(RADIUS)) <= RADIUS);
+    }
+
+    std::vector<glm::vec2> disk(COUNT);
+    glm::diskRand(disk.data(), disk.size(), RADIUS);
+    float outer = 0.0f;
+    for (const glm::vec2& value : disk)
+    {
+        CHECK(glm::length(value) <= RADIUS + RADIUS_TOLERANCE);
+        outer = glm::max(outer, glm::length(value));
+    }
+    CHECK(outer > RADIUS * 0.99f); // fills the disk rather than a smaller one
+
+    std::vector<glm::vec3> ball(COUNT);
+    glm::ballRand(ball.data(), ball.size(), RADIUS);
+    outer = 0.0f;
+    for (const glm::vec3& value : ball)
+    {
+        CHECK(glm::length(value) <= RADIUS + RADIUS_TOLERANCE);
+        outer = glm::max(outer, glm::length(value));
+    }
+    CHECK(outer > RADIUS * 0.99f);
+}
+
+static void test_circle_and_sphere_on_radius()
+{
+    glm::seedRand(3);
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+        CHECK(glm::abs(glm::length(glm::circularRand(RADIUS)) - RADIUS) <= RADIUS_TOLERANCE);
+        CHECK(glm::abs(glm::length(glm::sphericalRand(RADIUS)) - RADIUS) <= RADIUS_TOLERANCE);
+    }
+
+    std::vector<glm::vec2> circle(COUNT);
+    glm::circularRand(circle.data(), circle.size(), RADIUS);
+    for (const glm::vec2& value : circle) CHECK(glm::abs(glm::length(value) - RADIUS) <= RADIUS_TOLERANCE);
+
+    std::vector<glm::vec3> sphere(COUNT);
+    glm::sphericalRand(sphere.data(), sphere.size(), RADIUS);
+    for (const glm::vec3& value : sphere) CHECK(glm::abs(glm::length(value) - RADIUS) <= RADIUS_TOLERANCE);
+}
+
+int main()
+{
+    test_same_seed_reproduces();
+    test_linear_rand_in_range();
+    test_disk_and_ball_inside_radius();
+    test_circle_and_sphere_on_radius();
+    return test_exit_code();
+}
@@ -0,0 +1,135 @@
+#include "test_common.h"
+#include "RenderThread.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<int> g_frames_drawn{ 0 };
+static std::atomic<int> g_last_sprite_count{ -1 };
+
+// stands in for a swap that blocks on vsync
+static void slow_render(const RenderFrame& frame)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    g_last_sprite_count.store(frame.sprite_count);
+    g_frames_drawn.fetch_add(1);
+}
+
+// no window or context, the thread only needs somewhere to send frames
+static void start_render_thread(RenderThread& render_thread)
+{
+    g_frames_drawn.store(0);
+    g_last_sprite_count.store(-1);
+    render_thread.start(NULL, NULL, slow_render, NULL);
+}
+
+// the game loop waits before its first submit, which has to return straight away
+static void test_wait_with_nothing_in_flight()
+{
+    RenderThread render_thread;
+    start_render_thread(render_thread);
+
+    render_thread.wait_for_present();
+    CHECK(g_frames_drawn.load() == 0);
+
+    render_thread.stop();
+}
+
+// the loop run by --pacing vsync-locked: every frame is drawn, none are
+// skipped or dropped, and each wait ends with the frame on screen
+static void test_locked_loop_draws_every_frame()
+{
+    const int FRAME_COUNT = 20;
+    RenderThread render_thread;
+    start_render_thread(render_thread);
+
+    int dropped = 0;
+    for (int i = 0; i < FRAME_COUNT; i++)
+    {
+        render_thread.wait_for_present();
+        CHECK(g_frames_drawn.load() == i);
+
+        RenderFrame frame;
+        frame.sprite_count = i;
+        if (!render_thread.submit(frame)) dropped++;
+    }
+    render_thread.wait_for_present();
+
+    CHECK(dropped == 0);
+    CHECK(g_frames_drawn.load() == FRAME_COUNT);
+    CHECK(g_last_sprite_count.load() == FRAME_COUNT - 1);
+
+    render_thread.stop();
+}
+
+// the loop run by --pacing vsync: the next frame is built while the last is
+// drawn, so the render thread never has two to choose between and skips none
+static void test_free_slot_loop_keeps_frames_in_flight()
+{
+    const int FRAME_COUNT = 20;
+    RenderThread render_thread;
+    start_render_thread(render_thread);
+
+    int dropped = 0;
+    for (int i = 0; i < FRAME_COUNT; i++)
+    {
+        render_thread.wait_for_free_slot();
+        CHECK(i - g_frames_drawn.load() <= 1); // only the frame being drawn
+
+        RenderFrame frame;
+        frame.sprite_count = i;
+        if (!render_thread.submit(frame)) dropped++;
+    }
+    render_thread.wait_for_present();
+
+    CHECK(dropped == 0);
+    CHECK(g_frames_drawn.load() == FRAME_COUNT);
+    CHECK(g_last_sprite_count.load() == FRAME_COUNT - 1);
+
+    render_thread.stop();
+}
+
+// the render thread sleeps rather than spinning while nothing is submitted,
+// and wakes for the next frame
+static void test_idle_render_thread_wakes_for_a_frame()
+{
+    RenderThread render_thread;
+    start_render_thread(render_thread);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(g_frames_drawn.load() == 0);
+
+    RenderFrame frame;
+    frame.sprite_count = 3;
+    CHECK(render_thread.submit(frame));
+    render_thread.wait_for_present();
+    CHECK(g_frames_drawn.load() == 1);
+    CHECK(g_last_sprite_count.load() == 3);
+
+    render_thread.stop();
+}
+
+// quitting stops the render thread before joining the game thread, so a wait
+// for a frame that will never be drawn has to give up
+static void test_wait_returns_after_stop()
+{
+    RenderThread render_thread;
+    start_render_thread(render_thread);
+    render_thread.stop();
+
+    RenderFrame frame;
+    CHECK(render_thread.submit(frame));
+    CHECK(render_thread.submit(frame));
+    render_thread.wait_for_present();
+    render_thread.wait_for_free_slot();
+    CHECK(g_frames_drawn.load() == 0);
+}
+
+int main()
+{
+    test_wait_with_nothing_in_flight();
+    test_locked_loop_draws_every_frame();
+    test_free_slot_loop_keeps_frames_in_flight();
+    test_idle_render_thread_wakes_for_a_frame();
+    test_wait_returns_after_stop();
+    return test_exit_code();
+}
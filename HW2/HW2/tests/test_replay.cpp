@@ -0,0 +1,123 @@
+#include "test_common.h"
+#include "Replay.h"
+#include "Simulation.h"
+#include <cstdio>
+#include <vector>
+
+const char REPLAY_TEST_PATH[] = "test_replay.hw2r";
+
+// a match's worth of inputs that change every so often, with a gap long
+// enough to need a multi-byte varint
+static Replay make_replay(size_t tick_count)
+{
+    Replay replay;
+    uint32_t random = 12345;
+    uint8_t input = INPUT_LEFT_UP;
+    for (size_t tick = 0; tick < tick_count; tick++)
+    {
+        random = random * 1664525u + 1013904223u;
+        if (tick > 1000 && tick < 1300) input = 0;
+        else if ((random >> 24) < 8) input = (uint8_t)((random >> 8) & 0x0F);
+        replay.inputs.push_back(input);
+    }
+
+    GameState final_state;
+    replay.final_hash = replay_simulate(replay, final_state);
+    return replay;
+}
+
+static void test_simulation_is_deterministic()
+{
+    Replay replay = make_replay(4000);
+    GameState first, second;
+    CHECK(replay_simulate(replay, first) == replay_simulate(replay, second));
+    CHECK(simulation_hash(first) == simulation_hash(second));
+    CHECK(first.tick == 4000);
+
+    // one different input changes the outcome
+    Replay short_match;
+    short_match.inputs.assign(200, INPUT_LEFT_UP);
+    uint64_t hash = replay_simulate(short_match, first);
+    short_match.inputs[100] = INPUT_LEFT_DOWN;
+    CHECK(replay_simulate(short_match, second) != hash);
+    CHECK(second.left_cowboy_position.y < first.left_cowboy_position.y);
+}
+
+static void test_hash_covers_the_state()
+{
+    GameState state, other;
+    simulation_reset(state);
+    simulation_reset(other);
+    CHECK(simulation_hash(state) == simulation_hash(other));
+
+    other.tick++;
+    CHECK(simulation_hash(state) != simulation_hash(other));
+
+    other = state;
+    other.tumbleweed_position.y += 0.001f;
+    CHECK(simulation_hash(state) != simulation_hash(other));
+}
+
+static void test_replay_round_trip()
+{
+    Replay replay = make_replay(5000);
+    CHECK(replay_save(REPLAY_TEST_PATH, replay));
+
+    Replay loaded;
+    CHECK(replay_load(REPLAY_TEST_PATH, loaded));
+    CHECK(loaded.inputs == replay.inputs);
+    CHECK(loaded.final_hash == replay.final_hash);
+
+    // what --replay checks
+    GameState final_state;
+    CHECK(replay_simulate(loaded, final_state) == replay.final_hash);
+
+    Replay empty;
+    CHECK(replay_save(REPLAY_TEST_PATH, empty));
+    CHECK(replay_load(REPLAY_TEST_PATH, loaded));
+    CHECK(loaded.inputs.empty());
+}
+
+static void test_replay_rejects_damaged_files()
+{
+    Replay replay = make_replay(2000), loaded;
+    CHECK(replay_save(REPLAY_TEST_PATH, replay));
+
+    std::vector<uint8_t> data;
+    FILE* file = fopen(REPLAY_TEST_PATH, "rb");
+    CHECK(file != NULL);
+    if (file == NULL) return;
+    int byte;
+    while ((byte = fgetc(file)) != EOF) data.push_back((uint8_t)byte);
+    fclose(file);
+
+    struct Damage
+    {
+        const char* name;
+        std::vector<uint8_t> data;
+    };
+    std::vector<Damage> damaged;
+    damaged.push_back({ "bad magic", data });
+    damaged.back().data[0] = 'X';
+    damaged.push_back({ "truncated header", std::vector<uint8_t>(data.begin(), data.begin() + 10) });
+    damaged.push_back({ "last record cut off", std::vector<uint8_t>(data.begin(), data.end() - 1) });
+
+    for (const Damage& damage : damaged)
+    {
+        file = fopen(REPLAY_TEST_PATH, "wb");
+        fwrite(damage.data.data(), 1, damage.data.size(), file);
+        fclose(file);
+        if (replay_load(REPLAY_TEST_PATH, loaded)) std::printf("loaded a replay with %s\n", damage.name);
+        CHECK(!replay_load(REPLAY_TEST_PATH, loaded));
+    }
+}
+
+int main()
+{
+    test_simulation_is_deterministic();
+    test_hash_covers_the_state();
+    test_replay_round_trip();
+    test_replay_rejects_damaged_files();
+    remove(REPLAY_TEST_PATH);
+    return test_exit_code();
+}
@@ -0,0 +1,109 @@
+#include "test_common.h"
+#include "Rollback.h"
+#include "Simulation.h"
+#include "Transport.h"
+#include "glm/gtc/random.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+const uint32_t MATCH_TICKS = 400;
+// after the match both players let go, and play carries on until every
+// input of the match has reached the other side
+const uint32_t SETTLE_TICKS = ROLLBACK_WINDOW * 2;
+
+// both players' buttons for a tick, changing every so often; each session
+// is handed the whole byte and has to keep only its own player's bits
+static uint8_t match_input(uint32_t tick)
+{
+    if (tick >= MATCH_TICKS) return 0;
+    uint32_t random = (tick / 6) * 2654435761u;
+    random ^= random >> 15;
+    return (uint8_t)(random & 0x0F);
+}
+
+struct MatchConditions
+{
+    const char* name;
+    float latency_ms;
+    float jitter_ms;
+    float loss;
+    bool stalls; // the latency is past the rollback window
+};
+
+// two sessions over a loopback link, played a tick at a time with the
+// delivery delays running in real time
+static void test_sessions_converge(const MatchConditions& conditions)
+{
+    std::printf("  %s\n", conditions.name);
+    glm::seedRand(36); // the same packets are dropped each run
+
+    LoopbackTransport left_transport, right_transport;
+    LoopbackTransport::connect(left_transport, right_transport);
+    left_transport.set_conditions(conditions.latency_ms, conditions.jitter_ms, conditions.loss);
+    right_transport.set_conditions(conditions.latency_ms, conditions.jitter_ms, conditions.loss);
+
+    RollbackSession sessions[2];
+    sessions[0].start(0, &left_transport);
+    sessions[1].start(1, &right_transport);
+
+    // what the match should come to, simulated with every input known
+    const uint32_t tick_count = MATCH_TICKS + SETTLE_TICKS;
+    std::vector<uint64_t> expected_hashes;
+    GameState expected;
+    simulation_reset(expected);
+    for (uint32_t tick = 0; tick <= tick_count; tick++)
+    {
+        expected_hashes.push_back(simulation_hash(expected));
+        simulation_step(expected, match_input(tick));
+    }
+
+    int stalls = 0;
+    while (sessions[0].get_tick() < tick_count || sessions[1].get_tick() < tick_count)
+    {
+        // the settling ticks lose nothing, so the last packets get through
+        if (sessions[0].get_tick() >= MATCH_TICKS && sessions[1].get_tick() >= MATCH_TICKS)
+        {
+            left_transport.set_conditions(conditions.latency_ms, conditions.jitter_ms, 0.0f);
+            right_transport.set_conditions(conditions.latency_ms, conditions.jitter_ms, 0.0f);
+        }
+        for (RollbackSession& session : sessions)
+        {
+            if (session.get_tick() < tick_count && !session.advance(match_input(session.get_tick()))) stalls++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (const RollbackSession& session : sessions)
+    {
+        CHECK(session.get_confirmed_tick() > MATCH_TICKS);
+        CHECK(session.get_desync_count() == 0);
+        CHECK(session.get_checksums_checked() > 0);
+        CHECK(simulation_hash(session.get_state()) == expected_hashes[session.get_tick()]);
+    }
+    CHECK(simulation_hash(sessions[0].get_state()) == simulation_hash(sessions[1].get_state()));
+
+    // with any delay the remote input is predicted wrong at times
+    if (conditions.latency_ms > 0.0f || conditions.loss > 0.0f)
+    {
+        CHECK(sessions[0].get_rollback_count() + sessions[1].get_rollback_count() > 0);
+    }
+    CHECK((stalls > 0) == conditions.stalls);
+    std::printf("    rollbacks %u %u, checksums checked %u %u, stalls %d\n",
+        sessions[0].get_rollback_count(), sessions[1].get_rollback_count(),
+        sessions[0].get_checksums_checked(), sessions[1].get_checksums_checked(), stalls);
+}
+
+int main()
+{
+    const MatchConditions conditions[] = {
+        { "perfect link", 0.0f, 0.0f, 0.0f, false },
+        { "drops only", 0.0f, 0.0f, 0.3f, false },
+        { "latency and jitter", 10.0f, 8.0f, 0.0f, false },
+        { "latency, jitter and drops", 20.0f, 10.0f, 0.2f, false },
+        // the test ticks far faster than 240 Hz, so this is well past the window
+        { "latency past the window", 100.0f, 0.0f, 0.1f, true },
+    };
+    for (const MatchConditions& condition : conditions) test_sessions_converge(condition);
+    return test_exit_code();
+}
@@ -0,0 +1,67 @@
+#include "test_common.h"
+#include "SpscQueue.h"
+#include <cstdint>
+#include <thread>
+
+static void test_fills_and_drains_in_order()
+{
+    SpscQueue<int, 4> queue;
+    int item = -1;
+    CHECK(queue.empty());
+    CHECK(queue.peek() == NULL);
+    CHECK(!queue.try_pop(item));
+
+    // wraps around the buffer a few times
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 4; i++) CHECK(queue.try_push(round * 4 + i));
+        CHECK(!queue.try_push(99)); // full
+        CHECK(queue.peek() != NULL && *queue.peek() == round * 4);
+
+        for (int i = 0; i < 4; i++)
+        {
+            CHECK(queue.try_pop(item));
+            CHECK(item == round * 4 + i);
+        }
+        CHECK(queue.empty());
+    }
+}
+
+// one thread pushes a counting sequence while another pops it; anything lost,
+// repeated or reordered breaks the count
+static void test_two_threads()
+{
+    const uint32_t COUNT = 1000000;
+    SpscQueue<uint32_t, 64> queue;
+
+    std::thread producer([&queue]()
+    {
+        for (uint32_t i = 0; i < COUNT; i++)
+        {
+            while (!queue.try_push(i)) std::this_thread::yield();
+        }
+    });
+
+    uint32_t expected = 0, item, out_of_order = 0;
+    while (expected < COUNT)
+    {
+        if (!queue.try_pop(item))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item != expected) out_of_order++;
+        expected++;
+    }
+    producer.join();
+
+    CHECK(out_of_order == 0);
+    CHECK(queue.empty());
+}
+
+int main()
+{
+    test_fills_and_drains_in_order();
+    test_two_threads();
+    return test_exit_code();
+}
@@ -0,0 +1,295 @@
+#include "test_common.h"
+#include "TextureCompression.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Reference decoders written from the format specs, independent of the
+// encoders, so a bit layout mistake shows up as a bad round trip.
+
+static void unpack_565(uint16_t packed, int colour[3])
+{
+    int r = packed >> 11, g = (packed >> 5) & 0x3F, b = packed & 0x1F;
+    colour[0] = (r << 3) | (r >> 2);
+    colour[1] = (g << 2) | (g >> 4);
+    colour[2] = (b << 3) | (b >> 2);
+}
+
+// BC1 colour block into the RGB of 16 RGBA pixels; BC3 always uses four colours
+static void decode_bc1_colour(const uint8_t in[8], bool always_four_colours, uint8_t out[64])
+{
+    uint16_t colour0 = (uint16_t)(in[0] | in[1] << 8), colour1 = (uint16_t)(in[2] | in[3] << 8);
+    int palette[4][4];
+    unpack_565(colour0, palette[0]);
+    unpack_565(colour1, palette[1]);
+    palette[0][3] = palette[1][3] = 255;
+    for (int c = 0; c < 3; c++)
+    {
+        if (colour0 > colour1 || always_four_colours)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = colour0 > colour1 || always_four_colours ? 255 : 0;
+
+    uint32_t indices = (uint32_t)in[4] | (uint32_t)in[5] << 8 | (uint32_t)in[6] << 16 | (uint32_t)in[7] << 24;
+    for (int i = 0; i < 16; i++)
+    {
+        const int* colour = palette[(indices >> (i * 2)) & 3];
+        for (int c = 0; c < 4; c++) out[i * 4 + c] = (uint8_t)colour[c];
+    }
+}
+
+static void decode_bc3_alpha(const uint8_t in[8], uint8_t out[64])
+{
+    int palette[8] = { in[0], in[1] };
+    for (int i = 1; i < 7; i++)
+    {
+        if (in[0] > in[1]) palette[i + 1] = ((7 - i) * in[0] + i * in[1]) / 7;
+        else if (i < 5) palette[i + 1] = ((5 - i) * in[0] + i * in[1]) / 5;
+    }
+    if (in[0] <= in[1])
+    {
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++) indices |= (uint64_t)in[2 + i] << (i * 8);
+    for (int i = 0; i < 16; i++) out[i * 4 + 3] = (uint8_t)palette[(indices >> (i * 3)) & 7];
+}
+
+const int ETC_TABLES[8][2] = { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+
+static int clamp_byte(int value)
+{
+    return value < 0 ? 0 : value > 255 ? 255 : value;
+}
+
+// ETC1 modes only, which is all the encoder writes; false for anything ETC2 would read as T, H or planar
+static bool decode_etc_colour(const uint8_t in[8], uint8_t out[64])
+{
+    bool differential = (in[3] & 2) != 0, flip = (in[3] & 1) != 0;
+    int base[2][3];
+    for (int c = 0; c < 3; c++)
+    {
+        if (differential)
+        {
+            int first = in[c] >> 3, delta = in[c] & 7;
+            if (delta >= 4) delta -= 8;
+            int second = first + delta;
+            if (second < 0 || second > 31) return false;
+            base[0][c] = (first << 3) | (first >> 2);
+            base[1][c] = (second << 3) | (second >> 2);
+        }
+        else
+        {
+            base[0][c] = (in[c] >> 4) * 17;
+            base[1][c] = (in[c] & 0xF) * 17;
+        }
+    }
+    int table[2] = { in[3] >> 5, (in[3] >> 2) & 7 };
+
+    uint32_t indices = (uint32_t)in[4] << 24 | (uint32_t)in[5] << 16 | (uint32_t)in[6] << 8 | in[7];
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 4; x++)
+        {
+            int i = x * 4 + y; // down each column first
+            int subblock = (flip ? y : x) < 2 ? 0 : 1;
+            int msb = (indices >> (16 + i)) & 1, lsb = (indices >> i) & 1;
+            int modifier = ETC_TABLES[table[subblock]][lsb];
+            if (msb) modifier = -modifier;
+            for (int c = 0; c < 3; c++) out[(y * 4 + x) * 4 + c] = (uint8_t)clamp_byte(base[subblock][c] + modifier);
+            out[(y * 4 + x) * 4 + 3] = 255;
+        }
+    }
+    return true;
+}
+
+const int EAC_TABLES[16][8] = {
+    { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+static void decode_eac_alpha(const uint8_t in[8], uint8_t out[64])
+{
+    int base = in[0], multiplier = in[1] >> 4, table = in[1] & 0xF;
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++) indices = indices << 8 | in[2 + i];
+
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 4; x++)
+        {
+            int i = x * 4 + y; // first pixel in the top bits
+            int index = (int)(indices >> (45 - i * 3)) & 7;
+            out[(y * 4 + x) * 4 + 3] = (uint8_t)clamp_byte(base + EAC_TABLES[table][index] * multiplier);
+        }
+    }
+}
+
+static bool decode_block(TextureCompression compression, const uint8_t* in, uint8_t out[64])
+{
+    switch (compression)
+    {
+        case COMPRESSION_BC1:
+            decode_bc1_colour(in, false, out);
+            return true;
+        case COMPRESSION_BC3:
+            decode_bc1_colour(in + 8, true, out);
+            decode_bc3_alpha(in, out);
+            return true;
+        case COMPRESSION_ETC2_RGB8:
+            return decode_etc_colour(in, out);
+        default:
+            if (!decode_etc_colour(in + 8, out)) return false;
+            decode_eac_alpha(in, out);
+            return true;
+    }
+}
+
+// a sprite-like test image: smooth gradients, a hard edged shape, soft alpha at its rim
+static std::vector<uint8_t> make_image(int width, int height, bool with_alpha)
+{
+    std::vector<uint8_t> rgba((size_t)width * height * 4);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint8_t* pixel = &rgba[((size_t)y * width + x) * 4];
+            float dx = x - width * 0.5f, dy = y - height * 0.5f;
+            float distance = std::sqrt(dx * dx + dy * dy) / (width * 0.4f);
+            pixel[0] = (uint8_t)(x * 255 / (width - 1));
+            pixel[1] = (uint8_t)(y * 255 / (height - 1));
+            pixel[2] = distance < 0.5f ? 200 : 40;
+            pixel[3] = !with_alpha ? 255 : distance < 0.9f ? 255 : distance < 1.0f ? (uint8_t)((1.0f - distance) * 2550.0f) : 0;
+        }
+    }
+    return rgba;
+}
+
+// PSNR of the colour channels, over visible pixels only when alpha matters
+static double colour_psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, bool visible_only)
+{
+    double error = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < a.size(); i += 4)
+    {
+        if (visible_only && a[i + 3] == 0) continue;
+        for (int c = 0; c < 3; c++) error += (double)(a[i + c] - b[i + c]) * (a[i + c] - b[i + c]);
+        count += 3;
+    }
+    return error == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 * count / error);
+}
+
+// min_psnr is a little under what the encoders reach on this image, ETC's
+// fixed modifier tables can't follow gradients as closely as BC's endpoints
+static void test_round_trip(TextureCompression compression, const char* name, double min_psnr)
+{
+    bool has_alpha = compression == COMPRESSION_BC3 || compression == COMPRESSION_ETC2_EAC;
+    const int width = 64, height = 48; // 48 also tests blocks split across rows
+    std::vector<uint8_t> image = make_image(width, height, has_alpha);
+
+    std::vector<uint8_t> compressed(compressed_level_size(compression, width, height));
+    compress_block_rows(compression, image.data(), width, height, 0, height / 4, compressed.data());
+
+    std::vector<uint8_t> decoded(image.size());
+    bool decodable = true;
+    size_t block_size = compressed_block_size(compression);
+    for (int block_y = 0; block_y < height / 4; block_y++)
+    {
+        for (int block_x = 0; block_x < width / 4; block_x++)
+        {
+            uint8_t block[64];
+            decodable = decode_block(compression, &compressed[(block_y * (width / 4) + block_x) * block_size], block) && decodable;
+            for (int y = 0; y < 4; y++) memcpy(&decoded[((size_t)(block_y * 4 + y) * width + block_x * 4) * 4], &block[y * 16], 16);
+        }
+    }
+    CHECK(decodable);
+
+    double psnr = colour_psnr(image, decoded, has_alpha);
+    std::printf("%s colour PSNR %.1f dB\n", name, psnr);
+    CHECK(psnr > min_psnr);
+
+    if (has_alpha)
+    {
+        // BC3 keeps exact 0 and 255 for hard edged sprites, EAC only gets close
+        int worst_alpha_error = 0, hard_edges_changed = 0;
+        for (size_t i = 3; i < image.size(); i += 4)
+        {
+            int error = image[i] > decoded[i] ? image[i] - decoded[i] : decoded[i] - image[i];
+            if (error > worst_alpha_error) worst_alpha_error = error;
+            if ((image[i] == 0 || image[i] == 255) && error != 0) hard_edges_changed++;
+        }
+        std::printf("%s worst alpha error %d, changed hard alpha %d\n", name, worst_alpha_error, hard_edges_changed);
+        CHECK(worst_alpha_error <= 32);
+        if (compression == COMPRESSION_BC3) CHECK(hard_edges_changed == 0);
+    }
+}
+
+// a block of one colour should come back close to exactly for every format
+static void test_solid_blocks()
+{
+    const uint8_t colours[][4] = { { 0, 0, 0, 255 }, { 255, 255, 255, 255 }, { 200, 30, 90, 255 }, { 17, 130, 240, 128 } };
+    const TextureCompression compressions[] = { COMPRESSION_BC1, COMPRESSION_BC3, COMPRESSION_ETC2_RGB8, COMPRESSION_ETC2_EAC };
+    for (const uint8_t* colour : colours)
+    {
+        uint8_t block[64];
+        for (int i = 0; i < 16; i++) memcpy(&block[i * 4], colour, 4);
+
+        for (TextureCompression compression : compressions)
+        {
+            bool has_alpha = compression == COMPRESSION_BC3 || compression == COMPRESSION_ETC2_EAC;
+            if (!has_alpha && colour[3] != 255) continue;
+
+            uint8_t compressed[16], decoded[64];
+            compress_block_rows(compression, block, 4, 4, 0, 1, compressed);
+            CHECK(decode_block(compression, compressed, decoded));
+            for (int i = 0; i < 16; i++)
+            {
+                for (int c = 0; c < 3; c++) CHECK(std::abs(decoded[i * 4 + c] - colour[c]) <= 8);
+                if (has_alpha) CHECK(decoded[i * 4 + 3] == colour[3]);
+            }
+        }
+    }
+}
+
+// splitting the rows between threads must not change a single byte
+static void test_row_ranges_match_whole_image()
+{
+    const int width = 20, height = 30; // partial blocks on both edges
+    std::vector<uint8_t> image = make_image(width, height, true);
+    size_t size = compressed_level_size(COMPRESSION_BC3, width, height);
+    std::vector<uint8_t> whole(size), split(size);
+    compress_block_rows(COMPRESSION_BC3, image.data(), width, height, 0, 8, whole.data());
+    compress_block_rows(COMPRESSION_BC3, image.data(), width, height, 0, 3, split.data());
+    compress_block_rows(COMPRESSION_BC3, image.data(), width, height, 3, 8, split.data());
+    CHECK(whole == split);
+    CHECK(size == 5 * 8 * 16);
+}
+
+int main()
+{
+    test_round_trip(COMPRESSION_BC1, "BC1", 34.0);
+    test_round_trip(COMPRESSION_BC3, "BC3", 34.0);
+    test_round_trip(COMPRESSION_ETC2_RGB8, "ETC2 RGB8", 27.0);
+    test_round_trip(COMPRESSION_ETC2_EAC, "ETC2 EAC", 26.0);
+    test_solid_blocks();
+    test_row_ranges_match_whole_image();
+    return test_exit_code();
+}